@@ -52,7 +52,9 @@ export enum Code {
     Innerspace_NoEndpoints = 56,
     Launcher_TimedOutWhileGettingWorkerProcess = 58,
     Launcher_FailedToSpawnWorkerProcess = 59,
-    WorkerProcess_WorkerDeleted = 61
+    WorkerProcess_WorkerDeleted = 61,
+    Innerspace_RequestTimeout = 62,
+    ScriptEngine_ExecutionTimeout = 63
 }
 
 export function getCodeName(code: Code) {
@@ -161,6 +163,10 @@ export function getCodeName(code: Code) {
             return 'Launcher_FailedToSpawnWorkerProcess';
         case Code.WorkerProcess_WorkerDeleted:
             return 'WorkerProcess_WorkerDeleted';
+        case Code.Innerspace_RequestTimeout:
+            return 'Innerspace_RequestTimeout';
+        case Code.ScriptEngine_ExecutionTimeout:
+            return 'ScriptEngine_ExecutionTimeout';
         default:
             return `InternalError(${code})`;
     }
@@ -13,11 +13,21 @@
 #include <memory>
 #include <vector>
 #include <mutex>
-#include <queue>
+#include <array>
 #include <atomic>
 #include <functional>
 #include "local_config.h"
 
+//buffers are binned by capacity into power-of-two size classes starting at this size
+#define BUFFER_POOL_MIN_CLASS_SIZE (256)
+#define BUFFER_POOL_SIZE_CLASS_COUNT (17)
+//only classes up to this size are cached per thread, larger ones always go through the shared bins
+#define BUFFER_POOL_THREAD_CACHE_MAX_CLASS_SIZE (64 * 1024)
+#define BUFFER_POOL_DEFAULT_THREAD_CACHE_COUNT (8)
+#define BUFFER_POOL_DEFAULT_MAX_RETAINED_COUNT (4096)
+#define BUFFER_POOL_DEFAULT_MAX_RETAINED_BYTES (256 * 1024 * 1024)
+#define BUFFER_POOL_DEFAULT_MAX_RETAINED_BUFFER_SIZE (16 * 1024 * 1024)
+
 namespace estate {
     using InternalBuffer = std::string;
     using InternalBufferU = std::unique_ptr<std::string>;
@@ -33,6 +43,15 @@ namespace estate {
 
     struct BufferPoolConfig {
         const bool clear_on_get{true};
+        //buffers kept per size class in each thread's lock-free cache, 0 disables the cache
+        const u32 thread_cache_count{BUFFER_POOL_DEFAULT_THREAD_CACHE_COUNT};
+        //the shared bins stop retaining buffers past either limit, released buffers are freed instead. The thread caches aren't
+        //counted, each thread can hold up to thread_cache_count buffers of under twice BUFFER_POOL_THREAD_CACHE_MAX_CLASS_SIZE
+        //per cached class on top of these.
+        const u32 max_retained_count{BUFFER_POOL_DEFAULT_MAX_RETAINED_COUNT};
+        const u64 max_retained_bytes{BUFFER_POOL_DEFAULT_MAX_RETAINED_BYTES};
+        //buffers that grew beyond this are freed on release rather than pinned in the pool
+        const u64 max_retained_buffer_size{BUFFER_POOL_DEFAULT_MAX_RETAINED_BUFFER_SIZE};
         static BufferPoolConfig FromRemote(const LocalConfigurationReader &getter);
     };
 
@@ -53,36 +72,41 @@ namespace estate {
 
     class BufferPool : public std::enable_shared_from_this<BufferPool> {
         const BufferPoolConfig config;
+        //identifies this pool to the per-thread caches, an address could be reused by a later pool
+        const u64 id;
         std::atomic_int outstanding_leases{0};
         std::mutex buffers_mutex{};
-        std::queue<InternalBufferU> buffers{};
+        std::array<std::vector<InternalBufferU>, BUFFER_POOL_SIZE_CLASS_COUNT> buffers{};
+        size_t retained_count{0};
+        u64 retained_bytes{0};
 
         friend class BufferReference;
 
-        void release(InternalBufferU buffer) {
-            std::unique_lock<std::mutex> lck(buffers_mutex);
-            outstanding_leases.fetch_sub(1);
-            buffers.push(std::move(buffer));
-        }
+        void release(InternalBufferU buffer);
 
     public:
         BufferPool(BufferPoolConfig config);
 
         int outstanding_lease_count() const;
 
+        /* Buffers ready for reuse: the shared bins plus the calling thread's cache. */
         [[nodiscard]] size_t buffer_queue_count();
 
+        /* Capacity held by the shared bins. */
+        [[nodiscard]] u64 retained_byte_count();
+
         template<typename THeader, typename TPayload, typename TPayloadSize>
-        Envelope<THeader, TPayload, TPayloadSize> get_envelope() {
+        Envelope<THeader, TPayload, TPayloadSize> get_envelope(size_t payload_size_hint = 0) {
             using Envelope_ = Envelope<THeader, TPayload, TPayloadSize>;
-            auto buffer = get_buffer<typename Envelope_::_Envelope>();
+            auto buffer = get_buffer<typename Envelope_::_Envelope>(payload_size_hint > 0 ? sizeof(THeader) + payload_size_hint : 0);
             return Envelope_{std::move(buffer)};
         }
 
+        //size_hint picks the size class, a buffer of at least that capacity is returned. Without a hint any retained buffer is reused.
         template<typename T>
-        Buffer<T> get_buffer() {
+        Buffer<T> get_buffer(size_t size_hint = 0) {
             bool was_reused{false};
-            InternalBufferU internal_buffer = get_internal_buffer(was_reused);
+            InternalBufferU internal_buffer = get_internal_buffer(size_hint, was_reused);
             internal_buffer->clear();
             BufferReferenceS ref = std::make_shared<BufferReference>(std::move(internal_buffer), this->shared_from_this());
             Buffer<T> buffer{std::move(ref), was_reused};
@@ -90,7 +114,7 @@ namespace estate {
             return std::move(buffer);
         }
     private:
-        InternalBufferU get_internal_buffer(bool &was_reused);
+        InternalBufferU get_internal_buffer(size_t size_hint, bool &was_reused);
     };
 
     template<typename T>
@@ -114,11 +138,18 @@ namespace estate {
             assert(!_moved);
             const auto sz = _ref->get().size();
             assert(sz > 0);
-            Buffer<T> buffer = _ref->origin()->template get_buffer<T>();
+            Buffer<T> buffer = _ref->origin()->template get_buffer<T>(sz);
             buffer.resize(sz);
             std::memcpy(buffer.get(), get(), sz);
             return std::move(buffer);
         }
+        //hands the underlying buffer over to a Buffer of another type
+        template<typename R>
+        Buffer<R> reinterpret() && {
+            assert(!_moved);
+            _moved = true;
+            return Buffer<R>{std::move(_ref), _reused};
+        }
         BufferView<T> get_view() const {
             return BufferView<T>{
                     as_u8(),
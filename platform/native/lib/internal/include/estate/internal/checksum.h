@@ -0,0 +1,107 @@
+//
+// Originally written by Scott R. Jones.
+// Copyright (c) 2021 Warpdrive Technologies, Inc. All rights reserved.
+//
+
+#pragma once
+
+#include <estate/runtime/numeric_types.h>
+
+#include <array>
+#include <cstring>
+#include <cstddef>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ESTATE_CRC32C_X86 1
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define ESTATE_CRC32C_ARM 1
+#include <arm_acle.h>
+#endif
+
+namespace estate {
+    /* CRC-32C (Castagnoli) with the same interface as boost::crc_32_type. Uses the SSE4.2 crc32 instruction when the CPU
+     * has it, ARMv8 CRC32 when built for it, and a table otherwise. All three produce the same checksum. */
+    class Crc32c {
+        static constexpr u32 Polynomial = 0x82F63B78; //reflected
+        u32 _crc{0xFFFFFFFF};
+
+        static constexpr std::array<u32, 256> MakeTable() {
+            std::array<u32, 256> table{};
+            for (u32 i = 0; i < 256; ++i) {
+                u32 crc = i;
+                for (int j = 0; j < 8; ++j)
+                    crc = (crc >> 1) ^ ((crc & 1) ? Polynomial : 0);
+                table[i] = crc;
+            }
+            return table;
+        }
+        static u32 ProcessTable(u32 crc, const u8 *data, size_t size) {
+            static constexpr auto table = MakeTable();
+            for (size_t i = 0; i < size; ++i)
+                crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            return crc;
+        }
+#if ESTATE_CRC32C_X86
+        __attribute__((target("sse4.2")))
+        static u32 ProcessHardware(u32 crc, const u8 *data, size_t size) {
+            u64 crc64 = crc;
+            for (; size >= sizeof(u64); size -= sizeof(u64), data += sizeof(u64)) {
+                u64 word;
+                std::memcpy(&word, data, sizeof(u64));
+                crc64 = _mm_crc32_u64(crc64, word);
+            }
+            crc = static_cast<u32>(crc64);
+            for (; size; --size, ++data)
+                crc = _mm_crc32_u8(crc, *data);
+            return crc;
+        }
+        static bool HasHardware() {
+            static const bool has_sse42 = __builtin_cpu_supports("sse4.2");
+            return has_sse42;
+        }
+#elif ESTATE_CRC32C_ARM
+        static u32 ProcessHardware(u32 crc, const u8 *data, size_t size) {
+            for (; size >= sizeof(u64); size -= sizeof(u64), data += sizeof(u64)) {
+                u64 word;
+                std::memcpy(&word, data, sizeof(u64));
+                crc = __crc32cd(crc, word);
+            }
+            for (; size; --size, ++data)
+                crc = __crc32cb(crc, *data);
+            return crc;
+        }
+        static constexpr bool HasHardware() {
+            return true;
+        }
+#endif
+    public:
+        // Whether the hardware path is used, exposed for tests.
+        static bool is_hardware_accelerated() {
+#if ESTATE_CRC32C_X86 || ESTATE_CRC32C_ARM
+            return HasHardware();
+#else
+            return false;
+#endif
+        }
+        // Processes with the table even when there's hardware support, exposed for tests.
+        void process_bytes_portable(const void *data, size_t size) {
+            _crc = ProcessTable(_crc, static_cast<const u8 *>(data), size);
+        }
+        void process_bytes(const void *data, size_t size) {
+#if ESTATE_CRC32C_X86 || ESTATE_CRC32C_ARM
+            if (HasHardware()) {
+                _crc = ProcessHardware(_crc, static_cast<const u8 *>(data), size);
+                return;
+            }
+#endif
+            process_bytes_portable(data, size);
+        }
+        void process_byte(u8 byte) {
+            process_bytes(&byte, 1);
+        }
+        [[nodiscard]] u32 checksum() const {
+            return _crc ^ 0xFFFFFFFF;
+        }
+    };
+}
@@ -13,10 +13,15 @@
 #define ESTATE_DB_PROPERTY_KEY_SUFFIX "|P"
 #define ESTATE_DB_WORKER_INDEX_KEY "worker_index"
 #define ESTATE_DB_ENGINE_SOURCE_KEY "engine_data"
+#define ESTATE_DB_ENGINE_SNAPSHOT_KEY "engine_snapshot"
+#define ESTATE_DB_CODE_CACHE_KEY_PREFIX "code_cache|"
 #define ESTATE_DB_WORKER_VERSION_KEY "worker_version"
+#define ESTATE_DB_WARM_ENGINE_COUNT_KEY "warm_engine_count"
+#define ESTATE_DB_DELETED_KEY "deleted"
 
 namespace estate {
     std::string create_object_instance_key(const ClassId &class_id, const PrimaryKey &primary_key);
     std::string create_object_properties_index_key(const ClassId &class_id, const PrimaryKey &primary_key);
     std::string create_property_key(const ClassId &class_id, const PrimaryKey &primary_key, const std::string_view property_name);
+    std::string create_code_cache_key(const WorkerVersion &worker_version, u16 file_name_id);
 }
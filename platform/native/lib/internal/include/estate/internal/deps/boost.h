@@ -44,4 +44,8 @@ using Resolver = boost::asio::ip::tcp::resolver;
 using Acceptor = boost::asio::ip::tcp::acceptor;
 using ResolvedEndpoint = boost::asio::ip::basic_resolver_results<boost::asio::ip::tcp>;
 using Endpoint = boost::asio::ip::tcp::endpoint;
+//protocol independent stream types so the same connection can run over TCP or AF_UNIX
+using StreamSocket = boost::asio::generic::stream_protocol::socket;
+using StreamAcceptor = boost::asio::basic_socket_acceptor<boost::asio::generic::stream_protocol>;
+using StreamEndpoint = boost::asio::generic::stream_protocol::endpoint;
 using ExecutorStrand = boost::asio::strand<boost::asio::io_context::executor_type>;
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <rocksdb/version.h>
 #include <rocksdb/db.h>
 #include <rocksdb/options.h>
 #include <rocksdb/slice.h>
@@ -7,16 +7,79 @@
 #include "logging.h"
 #include <estate/runtime/deps/flatbuffers.h>
 
+#include <array>
+#include <cassert>
+#include <optional>
+
 namespace estate {
+    /* A FlatBuffers allocator that leases its blocks from a BufferPool, so builder storage is recycled across requests
+     * and a finished block can be handed out as a Buffer instead of being copied into a new one. */
+    class BufferPoolAllocator : public flatbuffers::Allocator {
+        //a builder holds one block, plus a second while it grows
+        static constexpr size_t MaxBlocks = 4;
+        BufferPoolS _buffer_pool;
+        std::array<std::optional<Buffer<u8>>, MaxBlocks> _blocks{};
+        std::optional<Buffer<u8>> *find_block(const u8 *p);
+    public:
+        explicit BufferPoolAllocator(BufferPoolS buffer_pool);
+        u8 *allocate(size_t size) override;
+        void deallocate(u8 *p, size_t size) override;
+        //takes the block starting at p out of the allocator, deallocate ignores it from then on
+        Buffer<u8> adopt(u8 *p);
+    };
+
+    namespace detail {
+        //constructed before the builder so the builder can point at it
+        struct BufferPoolAllocatorMember {
+            BufferPoolAllocator allocator;
+        };
+    }
+
+    /* A builder backed by a BufferPoolAllocator, finish it with finish_to_buffer. */
+    class PooledBuilder : private detail::BufferPoolAllocatorMember, public fbs::Builder {
+    public:
+        explicit PooledBuilder(BufferPoolS buffer_pool, size_t initial_size = 1024) :
+                detail::BufferPoolAllocatorMember{BufferPoolAllocator{std::move(buffer_pool)}},
+                fbs::Builder(initial_size, &allocator, false) {
+        }
+        PooledBuilder(const PooledBuilder &) = delete;
+        PooledBuilder(PooledBuilder &&) = delete;
+        BufferPoolAllocator &get_allocator() {
+            return allocator;
+        }
+    };
+
+    /* Turns the buffer that was just finished in the builder into a [ubyte] vector so it can be the nested_flatbuffer
+     * field of a table built next in the same builder, instead of being copied in from a second builder. A finished
+     * buffer is aligned to at least a uoffset_t so the length goes directly in front of it. */
+    inline fbs::Offset<fbs::Vector<u8>> nest_finished_buffer(fbs::Builder &builder) {
+        const auto size = static_cast<fbs::uoffset_t>(builder.GetSize());
+        assert(size % sizeof(fbs::uoffset_t) == 0);
+        return fbs::Offset<fbs::Vector<u8>>{builder.PushElement<fbs::uoffset_t>(size)};
+    }
+
     template<typename T>
     Buffer<T> finish_and_copy_to_buffer(fbs::Builder& builder, BufferPoolS buffer_pool, fbs::Offset<T> target) {
-        //TODO: remove the extra copy
         builder.Finish(target);
         auto ptr = builder.GetBufferPointer();
         auto sz = builder.GetSize();
-        Buffer<T> buffer = buffer_pool->get_buffer<T>();
+        Buffer<T> buffer = buffer_pool->get_buffer<T>(sz);
         buffer.resize(sz);
         std::memmove(buffer.as_u8(), ptr, sz);
         return std::move(buffer);
     }
+
+    /* Finishes the builder and hands its block over as the result. FlatBuffers builds back to front so the finished
+     * bytes are slid to the start of the same block, there's no second allocation. The builder can be reset and reused. */
+    template<typename T>
+    Buffer<T> finish_to_buffer(PooledBuilder &builder, fbs::Offset<T> target) {
+        builder.Finish(target);
+        size_t size{0};
+        size_t offset{0};
+        u8 *raw = builder.ReleaseRaw(size, offset);
+        Buffer<u8> block = builder.get_allocator().adopt(raw);
+        std::memmove(block.as_u8(), raw + offset, size);
+        block.resize(size);
+        return std::move(block).template reinterpret<T>();
+    }
 }
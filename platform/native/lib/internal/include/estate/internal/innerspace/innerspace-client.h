@@ -13,6 +13,13 @@
 #include <estate/runtime/model_types.h>
 
 namespace estate::innerspace {
+//Worker processes reached over AF_UNIX listen on sockets named after their WorkerId and these, so they don't need ports
+#define INNERSPACE_SETUP_WORKER_SOCKET_KIND "setup-worker"
+#define INNERSPACE_DELETE_WORKER_SOCKET_KIND "delete-worker"
+#define INNERSPACE_USER_SOCKET_KIND "user"
+
+    std::string make_worker_process_socket_name(WorkerId worker_id, const char *kind);
+
     using InnerspaceWorkerLoaderClientConfig = Innerspace<GetWorkerProcessEndpointRequestProto, GetWorkerProcessEndpointResponseProto>::Client::Config;
 
     struct InnerspaceClientConfig {
@@ -21,12 +28,19 @@ namespace estate::innerspace {
             u8 user_connection_count;
             u32 user_max_request_size;
             u32 user_max_response_size;
+            u32 user_max_write_batch_size{INNERSPACE_DEFAULT_MAX_WRITE_BATCH_SIZE};
+            u32 user_max_write_batch_count{INNERSPACE_DEFAULT_MAX_WRITE_BATCH_COUNT};
+            //when set the worker processes are on this host and are reached over AF_UNIX
+            std::string local_socket_dir{};
             static AsWorkerUser FromRemote(const LocalConfigurationReader &reader) {
                 return AsWorkerUser{
                         reader.get_string("host"),
                         reader.get_u8("user_connection_count"),
                         reader.get_u32("user_max_request_size"),
-                        reader.get_u32("user_max_response_size")
+                        reader.get_u32("user_max_response_size"),
+                        reader.get_u32("user_max_write_batch_size", INNERSPACE_DEFAULT_MAX_WRITE_BATCH_SIZE),
+                        reader.get_u32("user_max_write_batch_count", INNERSPACE_DEFAULT_MAX_WRITE_BATCH_COUNT),
+                        reader.get_string("local_socket_dir", "")
                 };
             }
         };
@@ -38,6 +52,12 @@ namespace estate::innerspace {
             u8 delete_worker_connection_count;
             u32 delete_worker_max_request_size;
             u32 delete_worker_max_response_size;
+            u32 setup_worker_max_write_batch_size{INNERSPACE_DEFAULT_MAX_WRITE_BATCH_SIZE};
+            u32 setup_worker_max_write_batch_count{INNERSPACE_DEFAULT_MAX_WRITE_BATCH_COUNT};
+            u32 delete_worker_max_write_batch_size{INNERSPACE_DEFAULT_MAX_WRITE_BATCH_SIZE};
+            u32 delete_worker_max_write_batch_count{INNERSPACE_DEFAULT_MAX_WRITE_BATCH_COUNT};
+            //when set the worker processes are on this host and are reached over AF_UNIX
+            std::string local_socket_dir{};
             static AsWorkerAdmin FromRemote(const LocalConfigurationReader &reader) {
                 return AsWorkerAdmin{
                         reader.get_string("host"),
@@ -46,12 +66,22 @@ namespace estate::innerspace {
                         reader.get_u32("setup_worker_max_response_size"),
                         reader.get_u8("delete_worker_connection_count"),
                         reader.get_u32("delete_worker_max_request_size"),
-                        reader.get_u32("delete_worker_max_response_size")
+                        reader.get_u32("delete_worker_max_response_size"),
+                        reader.get_u32("setup_worker_max_write_batch_size", INNERSPACE_DEFAULT_MAX_WRITE_BATCH_SIZE),
+                        reader.get_u32("setup_worker_max_write_batch_count", INNERSPACE_DEFAULT_MAX_WRITE_BATCH_COUNT),
+                        reader.get_u32("delete_worker_max_write_batch_size", INNERSPACE_DEFAULT_MAX_WRITE_BATCH_SIZE),
+                        reader.get_u32("delete_worker_max_write_batch_count", INNERSPACE_DEFAULT_MAX_WRITE_BATCH_COUNT),
+                        reader.get_string("local_socket_dir", "")
                 };
             }
         };
     };
 
+    struct WorkerProcessConnectionState {
+        WorkerId worker_id;
+        InnerspaceConnectionState connection;
+    };
+
     class InnerspaceClient {
         class Impl;
         Impl* _impl {nullptr};
@@ -61,15 +91,21 @@ namespace estate::innerspace {
                          InnerspaceClientConfig::AsWorkerAdmin admin_config);
         InnerspaceClient(BufferPoolS buffer_pool, IoContextS io_context, InnerspaceWorkerLoaderClientConfig worker_loader_config,
                          InnerspaceClientConfig::AsWorkerUser user_config);
+        //a request that times out completes with Innerspace_RequestTimeout and its late response is dropped
         void async_send(const LogContext &log_context, WorkerId worker_id,
                         Buffer<UserRequestProto> request_buffer,
-                        Innerspace<UserRequestProto, WorkerProcessUserResponseProto>::Client::Connection::ResponseHandler response_handler);
+                        Innerspace<UserRequestProto, WorkerProcessUserResponseProto>::Client::Connection::ResponseHandler response_handler,
+                        std::optional<std::chrono::milliseconds> timeout = std::nullopt);
         void async_send(const LogContext &log_context, WorkerId worker_id,
                         Buffer<SetupWorkerRequestProto> request_buffer,
-                        Innerspace<SetupWorkerRequestProto, SetupWorkerResponseProto>::Client::Connection::ResponseHandler response_handler);
+                        Innerspace<SetupWorkerRequestProto, SetupWorkerResponseProto>::Client::Connection::ResponseHandler response_handler,
+                        std::optional<std::chrono::milliseconds> timeout = std::nullopt);
         void async_send(const LogContext &log_context, WorkerId worker_id,
                         Buffer<DeleteWorkerRequestProto> request_buffer,
-                        Innerspace<DeleteWorkerRequestProto, DeleteWorkerResponseProto>::Client::Connection::ResponseHandler response_handler);
+                        Innerspace<DeleteWorkerRequestProto, DeleteWorkerResponseProto>::Client::Connection::ResponseHandler response_handler,
+                        std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+        /* The breaker state of every connection to a worker process, for diagnostics. */
+        std::vector<WorkerProcessConnectionState> get_connection_states();
     };
     using InnerspaceClientS = std::shared_ptr<InnerspaceClient>;
 }
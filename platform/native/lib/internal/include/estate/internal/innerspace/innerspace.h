@@ -19,11 +19,16 @@
 
 #include <utility>
 #include <vector>
+#include <chrono>
 #include <queue>
 #include <unordered_set>
 //#include <opencl-c-base.h>
 
 namespace estate {
+//Upper bounds on how much a connection's writer gathers into a single write when several messages are queued
+#define INNERSPACE_DEFAULT_MAX_WRITE_BATCH_SIZE (256 * 1024)
+#define INNERSPACE_DEFAULT_MAX_WRITE_BATCH_COUNT (32)
+
     struct InnerspaceClientEndpoint {
         bool operator==(const InnerspaceClientEndpoint &rhs) const;
         const std::string host;
@@ -33,17 +38,60 @@ namespace estate {
         };
     };
 
+    enum class BreakerState : u8 {
+        Closed,
+        Open,
+        HalfOpen,
+        Tripped
+    };
+    const char *get_breaker_state_name(BreakerState state);
+
+    struct BreakerConfig {
+        std::chrono::milliseconds min_backoff{50};
+        std::chrono::milliseconds max_backoff{5000};
+        //consecutive faults before giving up on the endpoint so the owner can replace it. Zero keeps retrying.
+        u32 max_attempts{0};
+    };
+
+    /* Closed admits everything. A fault opens it and the connection that opened it reconnects after a jittered exponential backoff,
+     * which half-opens it. Half-open admits a single tagged probe request and only that probe's response closes it again, a late
+     * response to an earlier request doesn't. After max_attempts consecutive faults it stays tripped. */
     class Breaker {
-        std::atomic_bool _fault{false};
+        const BreakerConfig _config;
+        std::atomic<BreakerState> _state{BreakerState::Closed};
+        std::mutex _mutex;
+        u32 _faults{0};
+        std::chrono::milliseconds _retry_delay{0};
+        std::optional<std::chrono::steady_clock::time_point> _probe_started_at{};
+        u64 _probe{0}; //the tag of the probe admitted last, 0 is never a probe
     public:
-        Breaker() = default;
+        Breaker() : Breaker(BreakerConfig{}) {}
+        explicit Breaker(BreakerConfig config) : _config{config} {}
         Breaker(const Breaker &) = delete;
         Breaker(Breaker &&) = delete;
+        /* Returns true when this fault opened the breaker, which makes the caller responsible for reconnecting. */
         bool fault();
+        void half_open();
+        /* Admits every request when closed, returning 0, and only the probe when half-open, returning its tag. Nothing is returned
+         * when the request isn't admitted. */
+        [[nodiscard]] std::optional<u64> try_acquire();
+        /* Closes a half-open breaker when the probe is the one admitted last. */
+        void succeed(u64 probe);
+        [[nodiscard]] std::chrono::milliseconds get_retry_delay();
+        /* Half-open isn't faulted because the probe has to get through. */
         [[nodiscard]] bool is_faulted() const;
+        [[nodiscard]] bool is_tripped() const;
+        [[nodiscard]] BreakerState get_state() const;
     };
     using BreakerS = std::shared_ptr<Breaker>;
 
+    struct InnerspaceConnectionState {
+        std::string peer_name;
+        BreakerState breaker_state;
+        bool is_connected;
+        u32 in_flight;
+    };
+
     ResultCode<ResolvedEndpoint, Code> resolve_endpoint(const std::string &host, u16 port, IoContextS io_context);
 
     template<typename TRequestProto,
@@ -78,15 +126,33 @@ namespace estate {
                 u8 connection_count;
                 u32 max_request_size;
                 u32 max_response_size;
+                u32 max_write_batch_size{INNERSPACE_DEFAULT_MAX_WRITE_BATCH_SIZE};
+                u32 max_write_batch_count{INNERSPACE_DEFAULT_MAX_WRITE_BATCH_COUNT};
+                //when set the server is on this host and is reached over AF_UNIX in this directory instead of TCP to host
+                std::string local_socket_dir{};
+                //the socket's name in local_socket_dir, named after the port when empty
+                std::string local_socket_name{};
                 static Config FromRemote(const LocalConfigurationReader &reader) {
                     return Config{
                             reader.get_string("host"),
                             reader.get_u16("port"),
                             reader.get_u8("connection_count"),
                             reader.get_u32("max_request_size"),
-                            reader.get_u32("max_response_size")
+                            reader.get_u32("max_response_size"),
+                            reader.get_u32("max_write_batch_size", INNERSPACE_DEFAULT_MAX_WRITE_BATCH_SIZE),
+                            reader.get_u32("max_write_batch_count", INNERSPACE_DEFAULT_MAX_WRITE_BATCH_COUNT),
+                            reader.get_string("local_socket_dir", "")
                     };
                 }
+                [[nodiscard]] bool is_local() const {
+                    return !local_socket_dir.empty();
+                }
+                [[nodiscard]] std::string get_local_socket_name() const {
+                    return local_socket_name.empty() ? std::to_string(port) : local_socket_name;
+                }
+                [[nodiscard]] std::string get_peer_name() const {
+                    return is_local() ? make_local_socket_path(local_socket_dir, get_local_socket_name()) : fmt::format("{}:{}", host, port);
+                }
             };
             class ConnectionPool;
             class Connection;
@@ -95,43 +161,58 @@ namespace estate {
             public:
                 using ResponseHandlerResult = ResultCode<ResponseEnvelope>;
                 using ResponseHandler = std::function<void(ResponseHandlerResult)>;
+                using Deadline = std::chrono::steady_clock::time_point;
+                /* The header and the caller's payload are written as one gathered buffer sequence so the payload is never copied. */
                 struct RequestBundle {
                     const LogContext log_context;
-                    RequestId request_id;
-                    ResponseHandler response_handler;
-                    RequestEnvelope request_message;
+                    RequestHeader header;
+                    Buffer<TRequestProto> payload;
                 };
-                Connection(const Config &config, BufferPoolS buffer_pool, Socket socket, ExecutorStrand strand, IoContextS io_context,
+                Connection(const Config &config, BufferPoolS buffer_pool, StreamSocket socket, ExecutorStrand strand, IoContextS io_context,
                            BreakerS breaker) :
                         _buffer_pool{std::move(buffer_pool)},
                         _config{config},
+                        _peer_name{config.get_peer_name()},
                         _socket{std::move(socket)},
                         _strand{std::move(strand)},
                         _io_context{io_context},
+                        _reconnect_timer{_strand},
                         _keep_running{false},
                         _breaker{breaker} {}
                 friend class ConnectionPool;
             private:
                 const Config _config;
-                std::optional<ResolvedEndpoint> _endpoint{};
+                const std::string _peer_name;
+                std::vector<StreamEndpoint> _endpoints{};
                 BufferPoolS _buffer_pool;
                 std::atomic<RequestId> _next_request_id{1};
                 std::mutex _connection_mutex;
-                Socket _socket;
+                StreamSocket _socket;
                 IoContextS _io_context;
                 ExecutorStrand _strand;
-                std::mutex _request_bundle_queue_mutex;
+                //only accessed from the strand
+                boost::asio::steady_timer _reconnect_timer;
+                std::atomic_bool _stopped{false};
+                //only accessed from the strand. Bundles wait in the queue while the previous batch is being written.
                 std::queue<RequestBundle> _request_bundle_queue;
+                std::vector<RequestBundle> _write_batch;
+                /* The timer is only set when the request has a deadline. Dropping the entry cancels it. */
+                struct PendingResponse {
+                    ResponseHandler response_handler;
+                    std::unique_ptr<boost::asio::steady_timer> deadline_timer;
+                    u64 probe; //the breaker's probe tag when this request is the probe, otherwise 0
+                };
                 std::mutex _response_map_mutex;
-                std::unordered_map<RequestId, ResponseHandler> _response_map;
-                std::unique_ptr<std::thread> _write_thread{};
-                std::unique_ptr<std::thread> _read_thread{};
+                std::unordered_map<RequestId, PendingResponse> _response_map;
+                //mirrors the response map's size so the pool can read it without the lock
+                std::atomic<u32> _in_flight{0};
+                //payload bytes accepted by async_send that haven't been written yet
+                std::atomic<u64> _queued_bytes{0};
+                //set by the pool when it hands this connection the breaker's probe, taken by the next request sent
+                std::atomic<u64> _next_probe{0};
                 BreakerS _breaker;
+                //true while the read loop is running
                 std::atomic_bool _keep_running;
-                Event _start_write;
-                Event _finish_write;
-                Event _start_read;
-                Event _finish_read;
             public:
                 UnitResultCode ensure_ready(const LogContext &log_context) {
                     using Result = UnitResultCode;
@@ -139,21 +220,36 @@ namespace estate {
                     if (_breaker->is_faulted())
                         return Result::Error(Code::Innerspace_ConnectionFault);
 
+                    return open(log_context);
+                }
+                [[nodiscard]] bool is_connected() const {
+                    return _keep_running;
+                }
+                [[nodiscard]] const std::string &get_peer_name() const {
+                    return _peer_name;
+                }
+            private:
+                UnitResultCode open(const LogContext &log_context) {
+                    using Result = UnitResultCode;
+
                     std::lock_guard<std::mutex> lck(_connection_mutex);
 
-                    if (!_endpoint.has_value()) {
-                        auto resolved_r = resolve_endpoint(_config.host, _config.port, _io_context);
-                        if (!resolved_r)
-                            return Result::Error(resolved_r.get_error());
-                        _endpoint = resolved_r.unwrap();
+                    if (_endpoints.empty()) {
+                        if (_config.is_local()) {
+                            _endpoints.push_back(make_local_endpoint(_config.local_socket_dir, _config.get_local_socket_name()));
+                        } else {
+                            auto resolved_r = resolve_endpoint(_config.host, _config.port, _io_context);
+                            if (!resolved_r)
+                                return Result::Error(resolved_r.get_error());
+                            for (const auto &entry: resolved_r.unwrap()) {
+                                _endpoints.emplace_back(entry.endpoint());
+                            }
+                        }
                     }
 
-                    bool threads_running = _write_thread != nullptr && _read_thread != nullptr;
                     bool is_open = _socket.is_open();
 
-                    if (!threads_running || !is_open) {
-                        stop_threads();
-
+                    if (!_keep_running || !is_open) {
                         if (is_open) {
                             disconnect();
                         }
@@ -162,64 +258,139 @@ namespace estate {
                         if (!c_r)
                             return Result::Error(c_r.get_error());
 
-                        auto s_r = start_threads();
-                        if (!s_r)
-                            return Result::Error(s_r.get_error());
+                        start_reading();
                     }
 
                     return Result::Ok();
                 }
+                /* Called by the connection whose fault opened the breaker. */
+                void schedule_reconnect() {
+                    boost::asio::post(_strand, [self{this->shared_from_this()}]() {
+                        if (self->_stopped || self->_breaker->is_tripped())
+                            return;
+
+                        const auto retry_delay = self->_breaker->get_retry_delay();
+                        sys_log_info("Reconnecting to {} in {}ms", self->_peer_name, retry_delay.count());
+
+                        self->_reconnect_timer.expires_after(retry_delay);
+                        self->_reconnect_timer.async_wait([weak_self{self->weak_from_this()}](const boost::system::error_code &error_code) {
+                            if (error_code)
+                                return;
+                            auto self = weak_self.lock();
+                            if (!self || self->_stopped)
+                                return;
+
+                            //a failed connect faults again, which backs off further and schedules the next attempt
+                            self->_breaker->half_open();
+                            if (self->open(LogContext{"innerspace-reconnect"}))
+                                sys_log_info("Reconnected to {}. Waiting for a probe to close the breaker.", self->_peer_name);
+                        });
+                    });
+                }
+            public:
                 void fault(const char *cause, const boost::system::error_code &error_code) {
                     if (_breaker->fault()) {
                         /*First fault*/
-                        sys_log_error("{} caused a fault from {}:{} because the code {} message {}",
-                                      cause, _endpoint.value()->host_name(), _endpoint.value()->service_name(),
-                                      error_code.value(), error_code.message());
+                        sys_log_error("{} caused a fault from {} because the code {} message {}. The breaker is now {}.",
+                                      cause, _peer_name, error_code.value(), error_code.message(),
+                                      get_breaker_state_name(_breaker->get_state()));
+                        schedule_reconnect();
                     } else {
-                        sys_log_trace("[[Previously faulted]] {} caused a fault from {}:{} because the code {} message {}",
-                                      cause, _endpoint.value()->host_name(), _endpoint.value()->service_name(),
-                                      error_code.value(), error_code.message());
+                        sys_log_trace("[[Previously faulted]] {} caused a fault from {} because the code {} message {}",
+                                      cause, _peer_name, error_code.value(), error_code.message());
                     }
 
-                    std::lock_guard<std::mutex> response_map_lock(_response_map_mutex);
-                    std::lock_guard<std::mutex> request_bundle_queue_lock(_request_bundle_queue_mutex);
-
-                    //stop threads and disconnect
-                    stop_threads();
+                    //stop reading and disconnect
+                    _keep_running = false;
                     if (_socket.is_open()) {
                         disconnect();
                         assert(!_socket.is_open());
                     }
 
                     //signal all the waiting handlers they should perform a client-side retry
-                    for (const auto[_, response_handler]: _response_map) {
-                        response_handler(ResultCode<ResponseEnvelope>::Error(Code::Innerspace_ConnectionFault));
-                    }
+                    fail_response_handlers(Code::Innerspace_ConnectionFault);
                 }
             public:
                 Connection(const Connection &other) = delete;
-                void async_send(const LogContext &log_context, const BufferView<TRequestProto> request_buffer, ResponseHandler response_handler) {
+                /* Requests awaiting a response come first since a stalled response holds up everything behind it, then bytes waiting to be written. */
+                [[nodiscard]] bool is_less_loaded_than(const Connection &other) const {
+                    const u32 in_flight = _in_flight.load(std::memory_order_relaxed);
+                    const u32 other_in_flight = other._in_flight.load(std::memory_order_relaxed);
+                    if (in_flight != other_in_flight)
+                        return in_flight < other_in_flight;
+                    return _queued_bytes.load(std::memory_order_relaxed) < other._queued_bytes.load(std::memory_order_relaxed);
+                }
+                [[nodiscard]] u32 get_in_flight_count() const {
+                    return _in_flight.load(std::memory_order_relaxed);
+                }
+                void carry_probe(u64 probe) {
+                    _next_probe = probe;
+                }
+                /* The request buffer's reference is held until the request is written. When a deadline is given and the response hasn't
+                 * arrived by then, the handler is completed with Innerspace_RequestTimeout and a late response is dropped. */
+                void async_send(const LogContext &log_context, Buffer<TRequestProto> request_buffer, ResponseHandler response_handler,
+                                std::optional<Deadline> deadline = std::nullopt) {
                     if (_breaker->is_faulted()) {
                         response_handler(ResponseHandlerResult::Error(Code::Innerspace_ConnectionFault));
                         return;
                     }
 
-                    auto bundle_r = bundle_request(log_context, request_buffer, response_handler);
+                    if (deadline.has_value() && deadline.value() <= std::chrono::steady_clock::now()) {
+                        response_handler(ResponseHandlerResult::Error(Code::Innerspace_RequestTimeout));
+                        return;
+                    }
+
+                    auto bundle_r = bundle_request(log_context, std::move(request_buffer));
                     if (!bundle_r) {
                         response_handler(ResponseHandlerResult::Error(bundle_r.get_error()));
                         return;
                     }
                     auto bundle = bundle_r.unwrap();
 
+                    /* The handler is registered before the request is written because with many requests in flight the response can be read
+                     * before the write completion runs. */
                     {
-                        std::lock_guard<std::mutex> lck(_request_bundle_queue_mutex);
-                        _request_bundle_queue.push(std::move(bundle));
-                        _start_write.notify_one();
+                        std::lock_guard<std::mutex> lck(_response_map_mutex);
+                        if (_breaker->is_faulted()) {
+                            response_handler(ResponseHandlerResult::Error(Code::Innerspace_ConnectionFault));
+                            return;
+                        }
+                        const RequestId request_id = bundle.header.request_id;
+                        std::unique_ptr<boost::asio::steady_timer> deadline_timer{};
+                        if (deadline.has_value()) {
+                            deadline_timer = std::make_unique<boost::asio::steady_timer>(*_io_context, deadline.value());
+                            deadline_timer->async_wait([weak_self{this->weak_from_this()}, request_id](const boost::system::error_code &error_code) {
+                                if (error_code)
+                                    return; //the response arrived first
+                                if (auto self = weak_self.lock())
+                                    self->expire_request(request_id);
+                            });
+                        }
+                        _response_map.emplace(request_id, PendingResponse{std::move(response_handler), std::move(deadline_timer), _next_probe.exchange(0)});
+                        _in_flight = _response_map.size();
                     }
+
+                    _queued_bytes.fetch_add(bundle.payload.size());
+
+                    //posts the write to the strand so the queue isn't accessed concurrently.
+                    boost::asio::post(_strand, [self{this->shared_from_this()}, bundle{std::move(bundle)}]() mutable {
+                        if (self->_breaker->is_faulted()) {
+                            self->_queued_bytes.fetch_sub(bundle.payload.size());
+                            return; //the response handler was already signaled by the fault
+                        }
+
+                        self->_request_bundle_queue.push(std::move(bundle));
+
+                        // are we already writing?
+                        if (!self->_write_batch.empty())
+                            return;
+
+                        self->async_write_requests();
+                    });
                 }
             private:
                 ResultCode<RequestBundle, Code>
-                bundle_request(const LogContext &log_context, const BufferView<TRequestProto> request_buffer, ResponseHandler response_handler) {
+                bundle_request(const LogContext &log_context, Buffer<TRequestProto> request_buffer) {
                     using Result = ResultCode<RequestBundle, Code>;
 
                     const auto request_size = request_buffer.size();
@@ -232,55 +403,76 @@ namespace estate {
 
                     RequestBundle bundle{
                             log_context,
-                            std::move(_next_request_id.fetch_add(1)),
-                            std::move(response_handler),
-                            std::move(_buffer_pool->get_envelope<RequestHeader, TRequestProto, u32>())
+                            RequestHeader{
+                                    _next_request_id.fetch_add(1),
+                                    static_cast<u32>(request_size)
+                            },
+                            std::move(request_buffer)
                     };
 
-                    bundle.request_message.resize_for_payload(request_size);
-
-                    RequestHeader *request_header = bundle.request_message.get_header();
-                    request_header->request_id = bundle.request_id;
-                    request_header->payload_size = request_size;
-
-                    std::memcpy(bundle.request_message.get_payload_raw(), request_buffer.as_char(), request_size);
-
-                    assert(bundle.request_message.get_payload_size() == request_size);
-                    assert(bundle.request_message.get_header_size() == sizeof(RequestHeader));
-                    assert(bundle.request_message.get_total_size() == request_size + sizeof(RequestHeader));
-
                     return Result::Ok(std::move(bundle));
                 }
-                void async_write_request(RequestBundle bundle) {
-                    log_trace(bundle.log_context, "Sending request {} of size {} bytes", bundle.request_id, bundle.request_message.get_total_size());
-
-                    auto buffer = boost::asio::buffer(bundle.request_message.get_header_raw(), bundle.request_message.get_total_size());
-
-                    std::shared_ptr<Connection> self{this->shared_from_this()};
+                /* Gathers everything queued, up to the configured batch limits, into a single write. Must be called from the strand. */
+                void async_write_requests() {
+                    assert(_write_batch.empty());
+                    assert(!_request_bundle_queue.empty());
+
+                    size_t batch_size = 0;
+                    do {
+                        auto &bundle = _request_bundle_queue.front();
+                        const size_t bundle_size = sizeof(RequestHeader) + bundle.payload.size();
+                        if (!_write_batch.empty() &&
+                            (batch_size + bundle_size > _config.max_write_batch_size || _write_batch.size() >= _config.max_write_batch_count))
+                            break;
+                        log_trace(bundle.log_context, "Sending request {} of size {} bytes", bundle.header.request_id, bundle_size);
+                        batch_size += bundle_size;
+                        _write_batch.push_back(std::move(bundle));
+                        _request_bundle_queue.pop();
+                    } while (!_request_bundle_queue.empty());
+
+                    //the batch isn't touched again until the write completes so the header addresses stay put
+                    std::vector<boost::asio::const_buffer> buffers{};
+                    buffers.reserve(_write_batch.size() * 2);
+                    for (auto &bundle: _write_batch) {
+                        buffers.emplace_back(boost::asio::buffer(&bundle.header, sizeof(RequestHeader)));
+                        buffers.emplace_back(boost::asio::buffer(bundle.payload.as_u8(), bundle.payload.size()));
+                    }
 
                     boost::asio::async_write(
                             _socket,
-                            buffer,
-                            [self, bundle{std::move(bundle)}]
-                                    (const boost::system::error_code &error_code, const std::size_t bytes_transferred) mutable {
+                            buffers,
+                            [self{this->shared_from_this()}](const boost::system::error_code &error_code, const std::size_t bytes_transferred) {
+                                for (const auto &bundle: self->_write_batch) {
+                                    self->_queued_bytes.fetch_sub(bundle.payload.size());
+                                }
+
                                 if (error_code) {
+                                    //the handlers of everything queued are in the response map so the fault signals them
                                     self->fault("Write request buffer", error_code);
-                                    //since this one hasn't been added to response_map, fire with empty to make it retry client-side
-                                    bundle.response_handler(ResultCode<ResponseEnvelope>::Error(Code::Innerspace_ConnectionFault));
+                                    self->_write_batch.clear();
+                                    for (; !self->_request_bundle_queue.empty(); self->_request_bundle_queue.pop()) {
+                                        self->_queued_bytes.fetch_sub(self->_request_bundle_queue.front().payload.size());
+                                    }
                                     return;
                                 }
 
-                                log_trace(bundle.log_context, "Request sent of {} bytes", bundle.request_message.get_total_size());
+                                sys_log_trace("Sent {} requests in {} bytes", self->_write_batch.size(), bytes_transferred);
 
-                                {
-                                    std::lock_guard<std::mutex> lck(self->_response_map_mutex);
-                                    self->_response_map[bundle.request_id] = bundle.response_handler;
-                                }
+                                self->_write_batch.clear();
 
-                                self->_finish_write.notify_one();
-                                self->_start_read.notify_one();
+                                //send whatever was queued while writing
+                                if (!self->_request_bundle_queue.empty())
+                                    self->async_write_requests();
                             });
                 }
+                void start_reading() {
+                    _keep_running = true;
+                    boost::asio::post(_strand, [self{this->shared_from_this()}]() {
+                        sys_log_trace("Read loop started");
+                        self->async_read_response();
+                    });
+                }
+                /* Reads responses one after another for as long as the connection is running. Must be called from the strand. */
                 void async_read_response() {
                     sys_log_trace("Starting to read response header of {} bytes.", sizeof(ResponseHeader));
 
@@ -296,7 +488,8 @@ namespace estate {
                                             [self, response_buffer{std::move(response_buffer)}](const boost::system::error_code &error_code,
                                                                                                 const std::size_t bytes_transferred) mutable {
                                                 if (error_code) {
-                                                    self->fault("Reading response header", error_code);
+                                                    if (self->_keep_running)
+                                                        self->fault("Reading response header", error_code);
                                                     return;
                                                 }
 
@@ -307,6 +500,8 @@ namespace estate {
                                                             "Error while getting response header. Payload size {} was bigger than max allowed {}",
                                                             response_buffer.get_header()->payload_size,
                                                             self->_config.max_response_size);
+                                                    //the stream can't be resynchronized so every request on it has to be retried
+                                                    self->fault("Reading response header", boost::asio::error::message_size);
                                                     return;
                                                 }
 
@@ -325,145 +520,105 @@ namespace estate {
                                                                         [self, response_buffer{std::move(response_buffer)}]
                                                                                 (const boost::system::error_code &error_code,
                                                                                  const std::size_t bytes_transferred) mutable {
-                                                                            //since all the socket work is done, the remainder can overlap.
-                                                                            self->_finish_read.notify_one();
-
                                                                             if (error_code) {
-                                                                                self->fault("Reading response payload", error_code);
+                                                                                if (self->_keep_running)
+                                                                                    self->fault("Reading response payload", error_code);
                                                                                 return;
                                                                             }
 
                                                                             sys_log_trace("Response payload of {} bytes received", bytes_transferred);
 
-                                                                            auto response_handler_o = self->get_response_handler(
+                                                                            auto pending_response_o = self->take_pending_response(
                                                                                     response_buffer.get_header()->request_id);
-                                                                            if (!response_handler_o) {
-                                                                                sys_log_warn(
-                                                                                        "Response handler wasn't found for request id {}. This may have been caused by a reset.",
+
+                                                                            //the probe's response proves the peer recovered, which closes a half-open breaker
+                                                                            if (pending_response_o && pending_response_o.value().probe != 0)
+                                                                                self->_breaker->succeed(pending_response_o.value().probe);
+
+                                                                            //since all the socket work is done, keep reading while the handler runs
+                                                                            if (self->_keep_running)
+                                                                                self->async_read_response();
+
+                                                                            if (!pending_response_o) {
+                                                                                sys_log_trace(
+                                                                                        "Dropped the response for request id {} because it already timed out or was reset.",
                                                                                         response_buffer.get_header()->request_id);
                                                                                 return;
                                                                             }
 
-                                                                            ResponseHandler response_handler = std::move(response_handler_o.value());
-
                                                                             sys_log_trace("Calling response handler for request id {}",
                                                                                           response_buffer.get_header()->request_id);
 
-                                                                            response_handler(
-                                                                                    ResultCode<ResponseEnvelope>::Ok(std::move(response_buffer)));
-
-                                                                            sys_log_trace("Handled response successfully");
+                                                                            //handlers run off the strand so a slow one doesn't hold up the reads and writes
+                                                                            boost::asio::post(*self->_io_context,
+                                                                                              [response_handler{std::move(pending_response_o.value().response_handler)},
+                                                                                                      response_buffer{std::move(response_buffer)}]() mutable {
+                                                                                                  response_handler(
+                                                                                                          ResultCode<ResponseEnvelope>::Ok(std::move(response_buffer)));
+                                                                                                  sys_log_trace("Handled response successfully");
+                                                                                              });
                                                                         });
                                             });
                 }
-                std::optional<ResponseHandler> get_response_handler(RequestId request_id) {
+                std::optional<PendingResponse> take_pending_response(RequestId request_id) {
                     std::lock_guard<std::mutex> lck(_response_map_mutex);
                     auto it = _response_map.find(request_id);
                     if (it == _response_map.end())
                         return std::nullopt;
-                    ResponseHandler response_handler = std::move(it->second);
+                    PendingResponse pending_response = std::move(it->second);
                     _response_map.erase(it);
-                    return response_handler;
+                    _in_flight = _response_map.size();
+                    pending_response.deadline_timer.reset(); //cancels it
+                    return pending_response;
                 }
-                std::optional<RequestBundle> get_request() {
-                    std::lock_guard<std::mutex> lck(_request_bundle_queue_mutex);
-                    if (_request_bundle_queue.empty())
-                        return std::nullopt;
-                    auto request = std::move(_request_bundle_queue.front());
-                    _request_bundle_queue.pop();
-                    return std::move(request);
+                void expire_request(RequestId request_id) {
+                    auto pending_response_o = take_pending_response(request_id);
+                    if (!pending_response_o)
+                        return;
+                    sys_log_warn("Request id {} to {} timed out before a response was received", request_id, _peer_name);
+                    pending_response_o.value().response_handler(ResponseHandlerResult::Error(Code::Innerspace_RequestTimeout));
                 }
-                void stop_threads() {
-                    _keep_running = false;
-                    if (_write_thread) {
-                        sys_log_trace("Stopping write thread");
-                        _start_write.notify_one();
-                        _finish_write.notify_one();
-                        _write_thread->join();
-                        _write_thread = nullptr;
-                        sys_log_trace("Write thread stopped");
+                void fail_response_handlers(Code code) {
+                    std::unordered_map<RequestId, PendingResponse> response_map{};
+                    {
+                        std::lock_guard<std::mutex> lck(_response_map_mutex);
+                        response_map.swap(_response_map);
+                        _in_flight = 0;
                     }
-                    if (_read_thread) {
-                        sys_log_trace("Stopping read thread");
-                        _start_read.notify_one();
-                        _finish_read.notify_one();
-                        _read_thread->join();
-                        _read_thread = nullptr;
-                        sys_log_trace("Stopped read thread");
+                    for (auto &[_, pending_response]: response_map) {
+                        pending_response.response_handler(ResponseHandlerResult::Error(code));
                     }
                 }
-                UnitResultCode start_threads() {
-                    assert(!_breaker->is_faulted());
-
-                    if (_write_thread) {
-                        sys_log_error("Send thread was already started when trying to start it.");
-                        return UnitResultCode::Error(Code::InnerspaceClientConnection_UnexpectedSendThreadAlreadyRunning);
-                    }
-
-                    if (_read_thread) {
-                        sys_log_error("Receive thread was already running when trying to start it");
-                        return UnitResultCode::Error(Code::InnerspaceClientConnection_UnexpectedRecvThreadAlreadyRunning);
-                    }
-
-                    _keep_running = true;
-
-                    std::shared_ptr<Connection> self{this->shared_from_this()};
-
-                    _write_thread = std::make_unique<std::thread>([self]() {
-                        sys_log_trace("Send thread started");
-                        while (self->_keep_running) {
-                            self->_start_write.wait_one();
-                            if (!self->_keep_running)
-                                break;
-                            while (auto request_o = self->get_request()) {
-                                auto request = std::move(request_o.value());
-                                self->async_write_request(std::move(request));
-                                self->_finish_write.wait_one();
-                                if (!self->_keep_running)
-                                    break;
-                            }
-                        }
-                        sys_log_trace("Send thread ended");
-                    });
-
-                    _read_thread = std::make_unique<std::thread>([self]() {
-                        sys_log_trace("Recv thread started");
-                        while (self->_keep_running) {
-                            self->_start_read.wait_one();
-                            if (!self->_keep_running)
-                                break;
-                            self->async_read_response();
-                            self->_finish_read.wait_one();
-                            if (!self->_keep_running)
-                                break;
-                        }
-                        sys_log_trace("Recv thread ended");
+                void stop() {
+                    _stopped = true;
+                    _keep_running = false;
+                    boost::asio::post(_strand, [self{this->shared_from_this()}]() {
+                        self->_reconnect_timer.cancel();
                     });
-
-                    return UnitResultCode::Ok();
+                    disconnect();
+                    fail_response_handlers(Code::Innerspace_Shutdown);
                 }
                 void disconnect() {
                     boost::system::error_code ec;
                     _socket.close(ec);
                     if (ec) {
-                        sys_log_error("Unable to close socket from {}:{}. Error: {}", _endpoint.value()->host_name(),
-                                      _endpoint.value()->service_name(), ec.message());
+                        sys_log_error("Unable to close socket from {}. Error: {}", _peer_name, ec.message());
                     }
                 }
                 UnitResultCode connect(const LogContext& log_context) {
                     using Result = UnitResultCode;
 
-                    assert(_endpoint.has_value());
+                    assert(!_endpoints.empty());
 
                     boost::system::error_code ec;
-                    boost::asio::connect(_socket, _endpoint.value(), ec);
+                    boost::asio::connect(_socket, _endpoints, ec);
 
                     if (ec) {
                         this->fault("Trying to connect", ec);
                         return Result::Error(Code::Innerspace_ConnectionFault);
                     }
 
-                    log_info(log_context, "Connection to {}:{} opened", _endpoint.value()->host_name(), _endpoint.value()->service_name());
+                    log_info(log_context, "Connection to {} opened", _peer_name);
 
                     return Result::Ok();
                 }
@@ -473,7 +628,7 @@ namespace estate {
                 const Config _config;
                 BreakerS _breaker;
                 std::vector<ConnectionS> _connections;
-                std::atomic<u8> _next_connection{0};
+                std::atomic<u32> _next_connection{0};
                 std::atomic_bool _keep_running{false};
                 friend class Client;
             public:
@@ -488,7 +643,7 @@ namespace estate {
 
                     for (int i = 0; i < count; ++i) {
                         ExecutorStrand strand = boost::asio::make_strand(*io_context);
-                        Socket socket{strand};
+                        StreamSocket socket{strand};
                         _connections.emplace_back(std::make_shared<Connection>(config,
                                                                                buffer_pool,
                                                                                std::move(socket),
@@ -502,28 +657,38 @@ namespace estate {
                 ResultCode<ConnectionS, Code> get_connection(const LogContext &log_context) {
                     using Result = ResultCode<ConnectionS, Code>;
 
-                    if (_breaker->is_faulted())
-                        return Result::Error(Code::Innerspace_ConnectionFault);
-
                     if (!_keep_running)
                         return Result::Error(Code::Innerspace_Shutdown);
 
-                    auto conn_index = _next_connection.fetch_add(1) % _count;
-                    ConnectionS connection = _connections[conn_index];
+                    //only lets the probe through while half-open
+                    const auto probe_o = _breaker->try_acquire();
+                    if (!probe_o)
+                        return Result::Error(Code::Innerspace_ConnectionFault);
+
+                    /* Picks the connection with the fewest outstanding requests. Pools are small so every connection is compared, and the
+                     * rotating start spreads ties round-robin. */
+                    const u32 start = _next_connection.fetch_add(1, std::memory_order_relaxed);
+                    ConnectionS connection = _connections[start % _count];
+                    for (u32 i = 1; i < _count; ++i) {
+                        const ConnectionS &candidate = _connections[(start + i) % _count];
+                        if (candidate->is_less_loaded_than(*connection))
+                            connection = candidate;
+                    }
 
                     auto ec_r = connection->ensure_ready(log_context);
                     if (!ec_r) {
                         log_error(log_context, "Failed to read connection because it couldn't ensure it was ready");
                         return Result::Error(ec_r.get_error());
                     }
+                    if (probe_o.value() != 0)
+                        connection->carry_probe(probe_o.value());
 
                     return Result::Ok(std::move(connection));
                 }
                 void shutdown() {
                     _keep_running = false;
                     for (ConnectionS connection: _connections) {
-                        connection->disconnect();
-                        connection->stop_threads();
+                        connection->stop();
                     }
                 }
             };
@@ -554,6 +719,24 @@ namespace estate {
                 return _breaker->is_faulted();
             }
 
+            /* The breaker gave up reconnecting so the endpoint should be looked up again. */
+            [[nodiscard]] bool is_tripped() const {
+                return _breaker->is_tripped();
+            }
+
+            [[nodiscard]] std::vector<InnerspaceConnectionState> get_connection_states() const {
+                std::vector<InnerspaceConnectionState> states{};
+                for (const ConnectionS &connection: _connection_pool->_connections) {
+                    states.push_back(InnerspaceConnectionState{
+                            connection->get_peer_name(),
+                            _breaker->get_state(),
+                            connection->is_connected(),
+                            connection->get_in_flight_count()
+                    });
+                }
+                return states;
+            }
+
             void shutdown() {
                 _keep_running = false;
                 _connection_pool->shutdown();
@@ -585,24 +768,27 @@ namespace estate {
         class Server : public std::enable_shared_from_this<Server> {
         public:
             struct Config {
-                Endpoint listen_endpoint;
+                //either a TCP endpoint or an AF_UNIX endpoint from make_local_endpoint
+                StreamEndpoint listen_endpoint;
                 u32 max_request_size;
                 u32 max_response_size;
+                u32 max_write_batch_size{INNERSPACE_DEFAULT_MAX_WRITE_BATCH_SIZE};
+                u32 max_write_batch_count{INNERSPACE_DEFAULT_MAX_WRITE_BATCH_COUNT};
                 static Config FromRemote(const LocalConfigurationReader &reader) {
-                    std::string listen_ip = reader.get_string("listen_ip");
-                    u16 listen_port = reader.get_u16("listen_port");
-                    return Config{
-                            make_endpoint(listen_ip, listen_port),
-                            reader.get_u32("max_request_size"),
-                            reader.get_u32("max_response_size")
-                    };
+                    return FromRemoteWithoutPort(reader, reader.get_u16("listen_port"));
                 }
-                static Config FromRemoteWithoutPort(const LocalConfigurationReader &reader, u16 listen_port) {
-                    std::string listen_ip = reader.get_string("listen_ip");
+                /* Listens in local_socket_dir over AF_UNIX when it's configured, otherwise on listen_ip over TCP. The socket is named
+                 * after the port unless it's given a name. */
+                static Config FromRemoteWithoutPort(const LocalConfigurationReader &reader, u16 listen_port, const std::string &local_socket_name = {}) {
+                    auto local_socket_dir = reader.try_get_string("local_socket_dir");
                     return Config{
-                            make_endpoint(listen_ip, listen_port),
+                            local_socket_dir.has_value() && !local_socket_dir->empty() ?
+                            make_local_endpoint(local_socket_dir.value(), local_socket_name.empty() ? std::to_string(listen_port) : local_socket_name) :
+                            StreamEndpoint{make_endpoint(reader.get_string("listen_ip"), listen_port)},
                             reader.get_u32("max_request_size"),
-                            reader.get_u32("max_response_size")
+                            reader.get_u32("max_response_size"),
+                            reader.get_u32("max_write_batch_size", INNERSPACE_DEFAULT_MAX_WRITE_BATCH_SIZE),
+                            reader.get_u32("max_write_batch_count", INNERSPACE_DEFAULT_MAX_WRITE_BATCH_COUNT)
                     };
                 }
             };
@@ -620,14 +806,22 @@ namespace estate {
                     assert(request_id > 0);
                     connection->async_send_response(log_context, request_id, std::move(response), std::move(and_then));
                 }
+                /* Sends the pooled buffer without copying it. The buffer's reference is held until the response is written. */
+                void async_respond(const LogContext &log_context, Buffer<TResponseProto> response, std::optional<std::function<void()>> and_then) {
+                    assert(connection);
+                    assert(request_id > 0);
+                    connection->async_send_response(log_context, request_id, std::move(response), std::move(and_then));
+                }
             private:
                 ServerConnectionS connection;
                 const RequestId request_id;
             };
             class ServerConnection : public std::enable_shared_from_this<ServerConnection> {
+                /* The header and the payload are written as one gathered buffer sequence so the payload is never copied. */
                 struct ResponseBundle {
                     const LogContext log_context;
-                    ResponseEnvelope response_envelope;
+                    ResponseHeader header;
+                    Buffer<TResponseProto> payload;
                     std::optional<std::function<void()>> and_then;
                 };
 
@@ -636,16 +830,14 @@ namespace estate {
                 BufferPoolS buffer_pool;
                 ServerRequestDispatcher request_dispatcher;
                 IoContextS io_context;
-                Socket socket;
+                StreamSocket socket;
                 ExecutorStrand strand;
-                Event start_write;
-                Event finish_write;
-                std::mutex response_queue_mutex;
+                //only accessed from the strand. Bundles wait in the queue while the previous batch is being written.
                 std::queue<ResponseBundle> response_queue;
-                std::unique_ptr<std::thread> write_thread;
+                std::vector<ResponseBundle> write_batch;
                 std::atomic_bool keep_running{false};
 
-                explicit ServerConnection(const Config &config, ServerS server, BufferPoolS buffer_pool, Socket &&socket, ExecutorStrand &&strand,
+                explicit ServerConnection(const Config &config, ServerS server, BufferPoolS buffer_pool, StreamSocket &&socket, ExecutorStrand &&strand,
                                           IoContextS io_context, ServerRequestDispatcher request_dispatcher) :
                         config(config),
                         server(std::move(server)),
@@ -658,15 +850,16 @@ namespace estate {
                 Create(const Config &config, ServerS server, BufferPoolS buffer_pool, IoContextS io_context,
                        ServerRequestDispatcher request_dispatcher) {
                     ExecutorStrand strand = boost::asio::make_strand(*io_context);
-                    Socket socket{strand};
+                    StreamSocket socket{strand};
                     return std::shared_ptr<ServerConnection>(
                             new ServerConnection(config, std::move(server), std::move(buffer_pool), std::move(socket),
                                                  std::move(strand), io_context, request_dispatcher));
                 }
                 void start() {
                     keep_running = true;
-                    start_thread();
-                    async_read_request();
+                    boost::asio::dispatch(strand, [self{this->shared_from_this()}]() {
+                        self->async_read_request();
+                    });
                 }
                 void stop() {
                     keep_running = false;
@@ -675,14 +868,6 @@ namespace estate {
                     if (ec) {
                         sys_log_warn("Error while closing socket: {}", ec.message());
                     }
-                    start_write.notify_one();
-                    finish_write.notify_one();
-                    if (write_thread) {
-                        sys_log_trace("Stopping write thread");
-                        write_thread->join();
-                        write_thread = nullptr;
-                        sys_log_trace("Write thread stopped");
-                    }
                 }
             public:
                 ~ServerConnection() {
@@ -690,30 +875,56 @@ namespace estate {
                     if (server->keep_running) //don't bother removing it if we're already shutting down
                         server->remove_connection(this->shared_from_this());
                 }
+                /* Copies the view into a pooled buffer. Prefer passing the Buffer itself when the caller has one. */
                 void async_send_response(const LogContext &log_context, RequestId request_id, const BufferView<TResponseProto> &response_buffer, std::optional<std::function<void()>> and_then) {
                     if (!keep_running) {
                         log_error(log_context, "Unable to send response because the connection was shutdown");
                         return;
                     }
 
-                    auto response_bundle_r = create_response_bundle(log_context, request_id, response_buffer, std::move(and_then));
+                    if (response_buffer.size() > config.max_response_size) {
+                        log_error(log_context, "For request id {}, the response size {} was bigger than the max response size {}", request_id,
+                                  response_buffer.size(), config.max_response_size);
+                        return;
+                    }
+
+                    Buffer<TResponseProto> payload = buffer_pool->get_buffer<TResponseProto>(response_buffer.size());
+                    payload.resize(response_buffer.size());
+                    std::memcpy(payload.as_u8(), response_buffer.as_u8(), response_buffer.size());
+
+                    async_send_response(log_context, request_id, std::move(payload), std::move(and_then));
+                }
+                void async_send_response(const LogContext &log_context, RequestId request_id, Buffer<TResponseProto> response_buffer, std::optional<std::function<void()>> and_then) {
+                    if (!keep_running) {
+                        log_error(log_context, "Unable to send response because the connection was shutdown");
+                        return;
+                    }
+
+                    auto response_bundle_r = create_response_bundle(log_context, request_id, std::move(response_buffer), std::move(and_then));
                     if (!response_bundle_r) {
                         return;
                     }
 
                     auto response_bundle = response_bundle_r.unwrap();
 
-                    std::lock_guard<std::mutex> lck(response_queue_mutex);
-                    response_queue.push(std::move(response_bundle));
-                    start_write.notify_one();
+                    //posts the write to the strand so the queue isn't accessed concurrently.
+                    boost::asio::post(strand, [self{this->shared_from_this()}, response_bundle{std::move(response_bundle)}]() mutable {
+                        self->response_queue.push(std::move(response_bundle));
+
+                        // are we already writing?
+                        if (!self->write_batch.empty())
+                            return;
+
+                        self->async_write_responses();
+                    });
                 }
             private:
                 friend class Server;
-                Socket &get_socket() {
+                StreamSocket &get_socket() {
                     return socket;
                 }
                 Result<ResponseBundle>
-                create_response_bundle(const LogContext &log_context, RequestId request_id, const BufferView<TResponseProto> &response_buffer,
+                create_response_bundle(const LogContext &log_context, RequestId request_id, Buffer<TResponseProto> response_buffer,
                                        std::optional<std::function<void()>> and_then) {
                     using Result = Result<ResponseBundle>;
 
@@ -723,28 +934,21 @@ namespace estate {
                         return Result::Error();
                     }
 
-                    ResponseEnvelope response_envelope = buffer_pool->get_envelope<ResponseHeader, TResponseProto, u32>();
-
-                    response_envelope.resize_for_payload(response_buffer.size());
-
-                    ResponseHeader *response_header = response_envelope.get_header();
-                    response_header->payload_size = response_buffer.size();
-                    response_header->request_id = request_id;
-
-                    std::memcpy(response_envelope.get_payload_raw(), response_buffer.as_u8(), response_buffer.size());
-
-                    assert(response_envelope.get_payload_size() == response_buffer.size());
-                    assert(response_envelope.get_header_size() == sizeof(RequestHeader));
-                    assert(response_envelope.get_total_size() == response_buffer.size() + sizeof(RequestHeader));
+                    const u32 payload_size = response_buffer.size();
 
                     ResponseBundle response_bundle{
                             log_context,
-                            std::move(response_envelope),
+                            ResponseHeader{
+                                    request_id,
+                                    payload_size
+                            },
+                            std::move(response_buffer),
                             std::move(and_then) //https://youtu.be/oqwzuiSy9y0?t=18
                     };
 
                     return Result::Ok(std::move(response_bundle));
                 }
+                /* Reads requests one after another for as long as the connection is running. Must be called from the strand. */
                 void async_read_request() {
                     sys_log_trace("Started reading requests");
                     RequestEnvelope request_envelope = buffer_pool->get_envelope<RequestHeader, TRequestProto, u32>();
@@ -815,57 +1019,62 @@ namespace estate {
                                                                         });
                                             });
                 }
-                std::optional<ResponseBundle> get_queued_response() {
-                    std::lock_guard<std::mutex> lck(response_queue_mutex);
-                    if (response_queue.empty())
-                        return std::nullopt;
-                    ResponseBundle response_bundle = std::move(response_queue.front());
-                    response_queue.pop();
-                    return std::move(response_bundle);
-                }
-                void async_write_response(ResponseBundle response_bundle) {
-                    auto buffer = boost::asio::buffer(response_bundle.response_envelope.get_header_raw(),
-                                                      response_bundle.response_envelope.get_total_size());
-                    boost::asio::async_write(socket, buffer,
-                                             [self{this->shared_from_this()}, response_bundle{std::move(response_bundle)}]
-                                                     (const boost::system::error_code &error_code, const std::size_t bytes_transferred) mutable {
-                                                 self->finish_write.notify_one();
+                /* Gathers everything queued, up to the configured batch limits, into a single write. Must be called from the strand. */
+                void async_write_responses() {
+                    assert(write_batch.empty());
+                    assert(!response_queue.empty());
+
+                    size_t batch_size = 0;
+                    do {
+                        auto &response_bundle = response_queue.front();
+                        const size_t bundle_size = sizeof(ResponseHeader) + response_bundle.payload.size();
+                        if (!write_batch.empty() &&
+                            (batch_size + bundle_size > config.max_write_batch_size || write_batch.size() >= config.max_write_batch_count))
+                            break;
+                        batch_size += bundle_size;
+                        write_batch.push_back(std::move(response_bundle));
+                        response_queue.pop();
+                    } while (!response_queue.empty());
+
+                    //the batch isn't touched again until the write completes so the header addresses stay put
+                    std::vector<boost::asio::const_buffer> buffers{};
+                    buffers.reserve(write_batch.size() * 2);
+                    for (auto &response_bundle: write_batch) {
+                        buffers.emplace_back(boost::asio::buffer(&response_bundle.header, sizeof(ResponseHeader)));
+                        buffers.emplace_back(boost::asio::buffer(response_bundle.payload.as_u8(), response_bundle.payload.size()));
+                    }
 
-                                                 RequestId request_id = response_bundle.response_envelope.get_header()->request_id;
+                    boost::asio::async_write(socket, buffers,
+                                             [self{this->shared_from_this()}]
+                                                     (const boost::system::error_code &error_code, const std::size_t bytes_transferred) mutable {
+                                                 std::vector<ResponseBundle> written{};
+                                                 written.swap(self->write_batch);
 
                                                  if (error_code) {
-                                                     log_error(response_bundle.log_context,
-                                                               "Error while sending response for request id {}. Message: {}", request_id,
-                                                               error_code.message());
+                                                     for (const auto &response_bundle: written) {
+                                                         log_error(response_bundle.log_context,
+                                                                   "Error while sending response for request id {}. Message: {}",
+                                                                   response_bundle.header.request_id, error_code.message());
+                                                     }
+                                                     //the socket is unusable so drop everything queued behind it
+                                                     std::queue<ResponseBundle>{}.swap(self->response_queue);
                                                      return;
                                                  }
 
-                                                 log_trace(response_bundle.log_context, "Response for request id {} sent successfully", request_id);
+                                                 //send whatever was queued while writing
+                                                 if (!self->response_queue.empty())
+                                                     self->async_write_responses();
 
-                                                 if(response_bundle.and_then.has_value()) {
-                                                     response_bundle.and_then.value()();
+                                                 for (auto &response_bundle: written) {
+                                                     log_trace(response_bundle.log_context, "Response for request id {} sent successfully",
+                                                               response_bundle.header.request_id);
+
+                                                     if (response_bundle.and_then.has_value()) {
+                                                         response_bundle.and_then.value()();
+                                                     }
                                                  }
                                              });
                 }
-                void start_thread() {
-                    assert(!write_thread);
-
-                    write_thread = std::make_unique<std::thread>([self{this->shared_from_this()}]() {
-                        sys_log_trace("Server write thread started");
-                        while (self->keep_running) {
-                            self->start_write.wait_one();
-                            if (!self->keep_running)
-                                break;
-                            while (auto response_bundle_o = self->get_queued_response()) {
-                                self->async_write_response(std::move(response_bundle_o.value()));
-                                self->finish_write.wait_one();
-                                if (!self->keep_running)
-                                    break;
-                            }
-                        }
-                        sys_log_trace("Server write thread stopped");
-                    });
-                }
             };
         private:
             friend class Innerspace;
@@ -874,7 +1083,7 @@ namespace estate {
             std::atomic_bool keep_running{false};
             BufferPoolS buffer_pool;
             IoContextS io_context;
-            Acceptor acceptor;
+            StreamAcceptor acceptor;
             ServerRequestDispatcher request_dispatcher;
             std::mutex connections_mutex;
             std::unordered_set<ServerConnectionS> connections;
@@ -883,7 +1092,7 @@ namespace estate {
                    IoContextS io_context, ServerRequestDispatcher &&request_dispatcher) :
                     buffer_pool(std::move(buffer_pool)),
                     request_dispatcher(std::move(request_dispatcher)),
-                    acceptor(*io_context, config.listen_endpoint),
+                    acceptor(*io_context, prepare_listen_endpoint(config.listen_endpoint)),
                     io_context(io_context),
                     config(config) {}
             void start() {
@@ -891,16 +1100,34 @@ namespace estate {
                 start_accept();
             }
             void shutdown() {
+                //cleared first so the cancelled accept doesn't start another one
+                keep_running = false;
                 boost::system::error_code ec;
                 acceptor.close(ec);
                 if (ec) {
                     sys_log_error( "Error while shutting down acceptor: {}", ec.message());
                 }
-                for (ServerConnectionS conn: connections) {
+                std::unordered_set<ServerConnectionS> stopping{};
+                {
+                    std::lock_guard<std::mutex> lck(connections_mutex);
+                    stopping = connections;
+                }
+                for (ServerConnectionS conn: stopping) {
                     conn->stop();
                 }
+                if (auto path = get_local_socket_path(config.listen_endpoint); path.has_value()) {
+                    boost::filesystem::remove(path.value(), ec);
+                }
             }
         private:
+            /* A local socket file left behind by a previous process would fail the bind so it's removed first. */
+            static const StreamEndpoint &prepare_listen_endpoint(const StreamEndpoint &endpoint) {
+                if (auto path = get_local_socket_path(endpoint); path.has_value()) {
+                    boost::system::error_code ec;
+                    boost::filesystem::remove(path.value(), ec);
+                }
+                return endpoint;
+            }
             void add_connection(const ServerConnectionS connection) {
                 std::lock_guard<std::mutex> lck(connections_mutex);
                 connections.insert(connection);
@@ -7,8 +7,15 @@
 #include <estate/internal/deps/boost.h>
 #include <estate/runtime/result.h>
 #include <string>
+#include <optional>
 
 namespace estate {
     Result<boost::asio::ip::address> get_ip_address(const std::string& interface_name);
     Endpoint make_endpoint(const std::string address, u16 port);
+    /* A local socket is named after the port it stands in for, or given a name when there's no port to stand in for. */
+    std::string make_local_socket_path(const std::string &socket_dir, const std::string &name);
+    std::string make_local_socket_path(const std::string &socket_dir, u16 port);
+    StreamEndpoint make_local_endpoint(const std::string &socket_dir, const std::string &name);
+    StreamEndpoint make_local_endpoint(const std::string &socket_dir, u16 port);
+    std::optional<std::string> get_local_socket_path(const StreamEndpoint &endpoint);
 }
\ No newline at end of file
@@ -5,14 +5,33 @@
 #pragma once
 
 #include <estate/runtime/result.h>
+#include <estate/runtime/numeric_types.h>
+#include "local_config.h"
 
 #include <memory>
+#include <optional>
 #include <mutex>
-#include <queue>
+#include <deque>
+#include <vector>
 #include <atomic>
+#include <chrono>
 #include <functional>
+#include <condition_variable>
 
 namespace estate {
+    struct PoolConfig {
+        size_t max_size{0}; //0 is unbounded, otherwise callers wait for a free resource once this many exist
+        u32 idle_timeout_ms{0}; //0 never evicts idle resources
+        u64 max_total_weight{0}; //0 is unbounded, otherwise idle resources are evicted while the total weight is over it
+        static PoolConfig FromRemote(const LocalConfigurationReader &reader) {
+            return PoolConfig{
+                    reader.get_u64("max_size", 0),
+                    reader.get_u32("idle_timeout_ms", 0),
+                    reader.get_u64("max_total_weight", 0)
+            };
+        }
+    };
+
     template<typename TResource, typename C>
     class Pool;
 
@@ -26,19 +45,22 @@ namespace estate {
         using ResourceU = std::unique_ptr<TResource>;
         using ResourceFactory = std::function<ResultCode<ResourceU, C>()>;
         using ResourceValidator = std::function<bool(ResourceU &)>;
+        // Measures a resource (e.g. an engine's heap) when it's released, for max_total_weight.
+        using ResourceWeigher = std::function<size_t(ResourceU &)>;
 
         class Handle {
             PoolS<TResource, C> pool;
         public:
-            Handle(ResourceU &&resource, PoolS<TResource, C> pool, bool reused) : _resource(std::move(resource)), pool(pool), _reused(reused) {}
+            Handle(ResourceU &&resource, PoolS<TResource, C> pool, bool reused, size_t weight) :
+                    _resource(std::move(resource)), pool(pool), _reused(reused), _weight(weight) {}
             Handle(const Handle &other) = delete;
-            Handle(Handle &&other) : _resource(std::move(other._resource)), pool(other.pool), _reused(other._reused) {
+            Handle(Handle &&other) : _resource(std::move(other._resource)), pool(other.pool), _reused(other._reused), _weight(other._weight) {
                 other._moved = true;
                 other.pool = nullptr;
             }
             ~Handle() {
                 if (!_moved) {
-                    pool->release(std::move(_resource));
+                    pool->release(std::move(_resource), _weight);
                 }
             }
         public:
@@ -50,77 +72,190 @@ namespace estate {
             ResourceU _resource;
             bool _moved{false};
             const bool _reused;
+            const size_t _weight; //as of the last release
         };
     private:
+        using Clock = std::chrono::steady_clock;
+        struct IdleResource {
+            ResourceU resource;
+            size_t weight;
+            Clock::time_point released;
+        };
+
+        const PoolConfig _config;
+        const ResourceWeigher _weigher;
         std::atomic_int _outstanding_leases{0};
+        std::atomic_int _peak_outstanding_leases{0};
         std::mutex _resources_mutex{};
-        std::queue<ResourceU> _resources{};
+        std::condition_variable _resource_released{};
+        // Most recently released at the back, so the least recently used age out from the front.
+        std::deque<IdleResource> _resources{};
+        size_t _resource_count{0}; //idle and leased
+        size_t _total_weight{0}; //idle and leased, as of their last release
+        size_t _evicted_count{0};
 
         friend class ResourceHandle;
-        void release(ResourceU &&buffer) {
-            std::unique_lock<std::mutex> lck(_resources_mutex);
-            _outstanding_leases.fetch_sub(1);
-            _resources.push(std::move(buffer));
+        void release(ResourceU &&resource, size_t previous_weight) {
+            const auto weight = _weigher ? _weigher(resource) : 0;
+            std::vector<ResourceU> evicted{};
+            {
+                std::unique_lock<std::mutex> lck(_resources_mutex);
+                _outstanding_leases.fetch_sub(1);
+                _total_weight = _total_weight - previous_weight + weight;
+                _resources.push_back(IdleResource{std::move(resource), weight, Clock::now()});
+                evict(evicted);
+            }
+            _resource_released.notify_one();
+            //destroyed outside the lock, they may be expensive to tear down
+        }
+        // Removes idle resources that have timed out or that put the pool over its weight budget. Requires the lock.
+        void evict(std::vector<ResourceU> &evicted) {
+            const auto now = Clock::now();
+            const auto idle_timeout = std::chrono::milliseconds(_config.idle_timeout_ms);
+            while (!_resources.empty()) {
+                auto &oldest = _resources.front();
+                const bool timed_out = _config.idle_timeout_ms > 0 && now - oldest.released >= idle_timeout;
+                const bool over_budget = _config.max_total_weight > 0 && _total_weight > _config.max_total_weight;
+                if (!timed_out && !over_budget)
+                    break;
+                _total_weight -= oldest.weight;
+                --_resource_count;
+                ++_evicted_count;
+                evicted.push_back(std::move(oldest.resource));
+                _resources.pop_front();
+            }
         }
     public:
-        Pool() = default;
+        explicit Pool(PoolConfig config = {}, ResourceWeigher weigher = nullptr) :
+                _config(config), _weigher(std::move(weigher)) {}
 
         int outstanding_lease_count() const {
             return _outstanding_leases;
         }
 
+        // The most resources that have been leased at the same time.
+        int peak_outstanding_lease_count() const {
+            return _peak_outstanding_leases;
+        }
+
         [[nodiscard]] size_t resource_queue_count() {
             std::unique_lock<std::mutex> lck(_resources_mutex);
             return _resources.size();
         }
+
+        [[nodiscard]] bool is_full() {
+            std::unique_lock<std::mutex> lck(_resources_mutex);
+            return _config.max_size > 0 && _resource_count >= _config.max_size;
+        }
+
+        [[nodiscard]] size_t resource_count() {
+            std::unique_lock<std::mutex> lck(_resources_mutex);
+            return _resource_count;
+        }
+
+        [[nodiscard]] size_t total_weight() {
+            std::unique_lock<std::mutex> lck(_resources_mutex);
+            return _total_weight;
+        }
+
+        [[nodiscard]] size_t evicted_count() {
+            std::unique_lock<std::mutex> lck(_resources_mutex);
+            return _evicted_count;
+        }
+
+        // Adds a resource that was created ahead of time so the next lease doesn't have to create it.
+        // Returns false, without adding it, when the pool is already full.
+        bool add_resource(ResourceU &&resource) {
+            const auto weight = _weigher ? _weigher(resource) : 0;
+            std::unique_lock<std::mutex> lck(_resources_mutex);
+            if (_config.max_size > 0 && _resource_count >= _config.max_size)
+                return false;
+            ++_resource_count;
+            _total_weight += weight;
+            _resources.push_back(IdleResource{std::move(resource), weight, Clock::now()});
+            lck.unlock();
+            _resource_released.notify_one();
+            return true;
+        }
+
+        // Evicts the idle resources that have timed out. Eviction otherwise only happens when a resource is released.
+        void evict_idle() {
+            std::vector<ResourceU> evicted{};
+            std::unique_lock<std::mutex> lck(_resources_mutex);
+            evict(evicted);
+        }
+
         ResultCode <Handle, C> get_resource(ResourceFactory factory, ResourceValidator validate) {
             using Result = ResultCode<Handle, C>;
 
             bool was_reused{false};
+            size_t weight{0};
 
-            auto resource_r = fetch_resource(factory, validate, was_reused);
+            auto resource_r = fetch_resource(factory, validate, was_reused, weight);
             if (!resource_r) {
                 return Result::Error(resource_r.get_error());
             }
             ResourceU resource = resource_r.unwrap();
 
-            Handle handle{std::move(resource), this->shared_from_this(), was_reused};
-            _outstanding_leases.fetch_add(1);
+            Handle handle{std::move(resource), this->shared_from_this(), was_reused, weight};
+            const auto outstanding = _outstanding_leases.fetch_add(1) + 1;
+            auto peak = _peak_outstanding_leases.load();
+            while (outstanding > peak && !_peak_outstanding_leases.compare_exchange_weak(peak, outstanding));
             return Result::Ok(std::move(handle));
         }
     private:
-        Result <ResourceU> try_fetch() {
-            using Result = Result<ResourceU>;
+        /* Takes the most recently released resource, or reserves room to create one. Waits while the pool is full and
+         * everything is leased. Returns nullopt when the caller should create a resource. */
+        std::optional<IdleResource> take_or_reserve() {
             std::unique_lock<std::mutex> lck(_resources_mutex);
+            while (_resources.empty() && _config.max_size > 0 && _resource_count >= _config.max_size)
+                _resource_released.wait(lck);
             if (!_resources.empty()) {
-                ResourceU internal_buffer = std::move(_resources.front());
-                _resources.pop();
-                return Result::Ok(std::move(internal_buffer));
+                auto idle = std::move(_resources.back());
+                _resources.pop_back();
+                return idle;
+            }
+            ++_resource_count;
+            return std::nullopt;
+        }
+        // Gives back a reservation whose resource couldn't be created.
+        void unreserve() {
+            {
+                std::unique_lock<std::mutex> lck(_resources_mutex);
+                --_resource_count;
             }
-            return Result::Error();
+            _resource_released.notify_one();
         }
-        ResultCode <ResourceU, C> fetch_resource(ResourceFactory &factory, ResourceValidator &validate, bool &was_reused) {
+        ResultCode <ResourceU, C> create_resource(ResourceFactory &factory, bool &was_reused) {
             using Result = ResultCode<ResourceU, C>;
-            auto try_resource_r = try_fetch();
-            if (try_resource_r) {
-                ResourceU resource = try_resource_r.unwrap();
-                if (!validate(resource)) {
-                    auto resource_r = factory();
-                    if (!resource_r)
-                        return Result::Error(resource_r.get_error());
-                    was_reused = false;
-                    return Result::Ok(std::move(resource_r.unwrap()));
-                } else {
-                    was_reused = true;
-                    return Result::Ok(std::move(resource));
-                }
-            } else {
-                auto resource_r = factory();
-                if (!resource_r)
-                    return Result::Error(resource_r.get_error());
-                was_reused = false;
-                return Result::Ok(std::move(resource_r.unwrap()));
+            auto resource_r = factory();
+            if (!resource_r) {
+                unreserve();
+                return Result::Error(resource_r.get_error());
+            }
+            was_reused = false;
+            return Result::Ok(std::move(resource_r.unwrap()));
+        }
+        ResultCode <ResourceU, C> fetch_resource(ResourceFactory &factory, ResourceValidator &validate, bool &was_reused, size_t &weight) {
+            using Result = ResultCode<ResourceU, C>;
+            auto maybe_idle = take_or_reserve();
+            if (!maybe_idle.has_value())
+                return create_resource(factory, was_reused);
+
+            auto idle = std::move(maybe_idle.value());
+            if (validate(idle.resource)) {
+                was_reused = true;
+                weight = idle.weight;
+                return Result::Ok(std::move(idle.resource));
+            }
+
+            // Replace the invalid resource, keeping its slot so waiters don't take it in the meantime
+            {
+                std::unique_lock<std::mutex> lck(_resources_mutex);
+                _total_weight -= idle.weight;
             }
+            idle.resource.reset();
+            return create_resource(factory, was_reused);
         }
     };
 }
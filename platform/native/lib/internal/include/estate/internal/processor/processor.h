@@ -6,10 +6,23 @@
 #include <estate/runtime/result.h>
 #include "estate/internal/flatbuffers_util.h"
 #include "estate/internal/logging.h"
+#include "estate/internal/processor/work_queue.h"
 
 #include <memory>
+#include <optional>
+#include <string>
 
 namespace estate {
+    // For executors that don't keep stats of their own.
+    struct NoExecutorStats {
+    };
+
+    template<typename TExecutorStats>
+    struct ProcessorStats {
+        WorkQueueStats work_queue;
+        TExecutorStats executor;
+    };
+
     template<
             typename TConfig,
             typename TRequestProto,
@@ -17,19 +30,46 @@ namespace estate {
             typename TServiceProvider,
             typename TRequestContext,
             typename TBuffer,
-            void Executor(const TConfig &config, std::shared_ptr<TServiceProvider>, TBuffer &&, std::shared_ptr<TRequestContext>)
+            typename TExecutorStats,
+            void Executor(const TConfig &config, std::shared_ptr<TServiceProvider>, TBuffer &&, std::shared_ptr<TRequestContext>, WorkQueue &,
+                          TExecutorStats &),
+            // Requests with the same key are executed one at a time in the order they arrived, nullopt runs without ordering.
+            std::optional<std::string> OrderingKey(TBuffer &) = nullptr
     >
     struct Processor {
         //[sic] do not delete these. CLion incorrectly says they're unused.
         using Config = TConfig;
         using ServiceProvider = TServiceProvider;
         using RequestContext = TRequestContext;
-        explicit Processor(const TConfig config, std::shared_ptr<TServiceProvider> service_provider) : _config(config), _service_provider(service_provider) {}
+        explicit Processor(const TConfig config, std::shared_ptr<TServiceProvider> service_provider, WorkQueueConfig work_queue_config = {}) :
+                _config(config), _service_provider(service_provider), _work_queue(std::make_unique<WorkQueue>(work_queue_config)) {}
+        /* Runs the executor on the work queue so the thread that read the request can go back to reading. The executor gets the queue
+         * so it can post follow-up work, and this processor's stats to update. */
         void post(TBuffer &&request_buffer, std::shared_ptr<TRequestContext> request_context) {
-            Executor(_config, _service_provider, std::move(request_buffer), std::move(request_context));
+            std::optional<std::string> maybe_key{};
+            if constexpr (OrderingKey != nullptr)
+                maybe_key = OrderingKey(request_buffer);
+            auto work = [this, request_buffer{std::move(request_buffer)}, request_context{std::move(request_context)}]() mutable {
+                Executor(_config, _service_provider, std::move(request_buffer), std::move(request_context), *_work_queue, _executor_stats);
+            };
+            if (maybe_key.has_value())
+                _work_queue->post_ordered(std::move(maybe_key.value()), std::move(work));
+            else
+                _work_queue->post(std::move(work));
+        }
+        void shutdown() {
+            _work_queue->shutdown();
+        }
+        [[nodiscard]] ProcessorStats<TExecutorStats> get_stats() const {
+            return ProcessorStats<TExecutorStats>{
+                    _work_queue->get_stats(),
+                    _executor_stats
+            };
         }
     private:
         const TConfig _config;
         std::shared_ptr<TServiceProvider> _service_provider;
+        TExecutorStats _executor_stats{};
+        WorkQueueU _work_queue;
     };
 }
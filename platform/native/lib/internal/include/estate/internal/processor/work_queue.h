@@ -0,0 +1,167 @@
+//
+// Created by scott on 10/17/2026.
+//
+#pragma once
+
+#include "estate/internal/thread_pool.h"
+#include "estate/internal/local_config.h"
+#include "estate/internal/logging.h"
+
+#include <estate/runtime/numeric_types.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <deque>
+#include <string>
+#include <thread>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+
+#define WORK_QUEUE_DEFAULT_MAX_DEPTH (1024)
+#define WORK_QUEUE_DEFAULT_SLOW_WAIT_MS (100)
+
+namespace estate {
+    struct WorkQueueConfig {
+        //0 runs work inline on the thread that posted it
+        u32 num_threads{0};
+        //once this much work is waiting new work runs inline on the posting thread, which pushes back on its reads
+        u32 max_depth{WORK_QUEUE_DEFAULT_MAX_DEPTH};
+        //work that waited longer than this before running is logged
+        u32 slow_wait_ms{WORK_QUEUE_DEFAULT_SLOW_WAIT_MS};
+        static WorkQueueConfig FromRemote(const LocalConfigurationReader &reader) {
+            return WorkQueueConfig{
+                    reader.get_u32("num_threads", 0),
+                    reader.get_u32("max_depth", WORK_QUEUE_DEFAULT_MAX_DEPTH),
+                    reader.get_u32("slow_wait_ms", WORK_QUEUE_DEFAULT_SLOW_WAIT_MS)
+            };
+        }
+    };
+
+    struct WorkQueueStats {
+        u32 depth;
+        u32 max_depth_seen;
+        u64 executed;
+        u64 ran_inline;
+        std::chrono::microseconds total_wait;
+        std::chrono::microseconds max_wait;
+        u64 ordered_waits; //ordered work that had to wait for earlier work with the same key
+    };
+
+    /* Moves work off the thread that received it onto a bounded set of worker threads. */
+    class WorkQueue {
+        const WorkQueueConfig _config;
+        std::unique_ptr<ThreadPool> _thread_pool{};
+        std::atomic<u32> _depth{0};
+        std::atomic<u32> _max_depth_seen{0};
+        std::atomic<u64> _executed{0};
+        std::atomic<u64> _ran_inline{0};
+        std::atomic<u64> _total_wait_us{0};
+        std::atomic<u64> _max_wait_us{0};
+        std::atomic<u64> _ordered_waits{0};
+        // Ordered work waiting behind the work that's running for its key. A key is present while its work is running.
+        std::mutex _ordered_mutex{};
+        std::unordered_map<std::string, std::deque<std::function<void()>>> _ordered{};
+        void record_enqueued(u32 depth);
+        void record_wait(std::chrono::steady_clock::duration wait);
+        bool _stopped{false}; //guarded by _ordered_mutex
+        void post_next_ordered(const std::string &key);
+        template<class F>
+        void post_maybe_ordered(std::optional<std::string> key, F work) {
+            if (key.has_value())
+                post_ordered(std::move(key.value()), std::move(work));
+            else
+                post(std::move(work));
+        }
+        // Requires the thread pool and that _depth already counts the work, which it does for parked ordered work.
+        template<class F>
+        void enqueue(u32 depth, F work) {
+            record_enqueued(depth);
+            _thread_pool->post([this, enqueued = std::chrono::steady_clock::now(), work{std::move(work)}]() mutable {
+                record_wait(std::chrono::steady_clock::now() - enqueued);
+                _depth.fetch_sub(1);
+                work();
+                _executed.fetch_add(1);
+            });
+        }
+    public:
+        explicit WorkQueue(WorkQueueConfig config);
+        ~WorkQueue();
+        WorkQueue(const WorkQueue &) = delete;
+        [[nodiscard]] bool is_inline() const;
+        template<class F>
+        void post(F work) {
+            if (!_thread_pool) {
+                work();
+                return;
+            }
+            const auto depth = _depth.fetch_add(1) + 1;
+            if (depth > _config.max_depth) {
+                _depth.fetch_sub(1);
+                _ran_inline.fetch_add(1);
+                work();
+                return;
+            }
+            enqueue(depth, std::move(work));
+        }
+        /* Runs work with the same key one at a time in the order it was posted, while work with other keys runs in parallel. Work
+         * posted while its key is busy waits outside the thread pool so it doesn't hold a thread, but it counts toward max_depth. Past
+         * that it runs inline on the posting thread like any other work and loses its order, which only saves write conflicts. */
+        template<class F>
+        void post_ordered(std::string key, F work) {
+            {
+                std::unique_lock<std::mutex> lck(_ordered_mutex);
+                auto[it, inserted] = _ordered.try_emplace(key);
+                if (!inserted) {
+                    if (!_thread_pool) {
+                        it->second.emplace_back(std::move(work));
+                        _ordered_waits.fetch_add(1);
+                        return;
+                    }
+                    const auto depth = _depth.fetch_add(1) + 1;
+                    if (depth <= _config.max_depth) {
+                        record_enqueued(depth);
+                        it->second.emplace_back(std::move(work));
+                        _ordered_waits.fetch_add(1);
+                        return;
+                    }
+                    _depth.fetch_sub(1);
+                    _ran_inline.fetch_add(1);
+                    lck.unlock();
+                    work();
+                    return;
+                }
+            }
+            post([this, key{std::move(key)}, work{std::move(work)}]() mutable {
+                work();
+                post_next_ordered(key);
+            });
+        }
+        /* Posts work once the delay has passed, ordered by the key when there is one. The wait is a timer so it doesn't hold a thread
+         * or the key. With no worker threads all work runs on the posting thread, so it sleeps through the delay instead. */
+        template<class F>
+        void post_after(std::optional<std::string> key, std::chrono::milliseconds delay, F work) {
+            if (delay.count() <= 0) {
+                post_maybe_ordered(std::move(key), std::move(work));
+                return;
+            }
+            if (!_thread_pool) {
+                std::this_thread::sleep_for(delay);
+                post_maybe_ordered(std::move(key), std::move(work));
+                return;
+            }
+            auto timer = std::make_shared<boost::asio::steady_timer>(*_thread_pool->get_context(), delay);
+            timer->async_wait([this, timer, key{std::move(key)}, work{std::move(work)}](const boost::system::error_code &error) mutable {
+                if (error)
+                    return; //cancelled at shutdown
+                post_maybe_ordered(std::move(key), std::move(work));
+            });
+        }
+        /* Stops the worker threads and waits for the work that's running to finish, anything still queued is dropped. */
+        void shutdown();
+        [[nodiscard]] WorkQueueStats get_stats() const;
+    };
+    using WorkQueueU = std::unique_ptr<WorkQueue>;
+}
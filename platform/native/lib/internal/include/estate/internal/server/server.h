@@ -129,14 +129,25 @@ namespace estate {
     namespace storage {
         struct ITransaction : public virtual std::enable_shared_from_this<ITransaction> {
             [[nodiscard]] virtual ResultCode<std::optional<data::Cell>> maybe_get_cell(const std::string &property_key) = 0;
+            // Reads the cells in one batch, returning them in the same order as the keys.
+            [[nodiscard]] virtual ResultCode<std::vector<std::optional<data::Cell>>> maybe_get_cells(const std::vector<std::string> &property_keys) = 0;
             [[nodiscard]] virtual ResultCode<Buffer<WorkerIndexProto>, Code> get_worker_index() = 0;
             [[nodiscard]] virtual ResultCode<Buffer<EngineSourceProto>, Code> get_engine_source() = 0;
+            [[nodiscard]] virtual ResultCode<std::optional<Buffer<u8>>, Code> maybe_get_engine_snapshot() = 0;
+            [[nodiscard]] virtual ResultCode<std::optional<Buffer<u8>>, Code> maybe_get_code_cache(u16 file_name_id) = 0;
             [[nodiscard]] virtual WorkerId get_worker_id() = 0;
             [[nodiscard]] virtual WorkerVersion get_worker_version() = 0;
             [[nodiscard]] virtual UnitResultCode delete_worker_index() = 0;
             [[nodiscard]] virtual UnitResultCode delete_engine_source() = 0;
+            [[nodiscard]] virtual UnitResultCode delete_engine_snapshot() = 0;
+            [[nodiscard]] virtual UnitResultCode delete_code_cache(u16 file_name_id) = 0;
             [[nodiscard]] virtual UnitResultCode save_worker_index(WorkerVersion new_worker_version, const BufferView<WorkerIndexProto> &worker_index) = 0;
             [[nodiscard]] virtual UnitResultCode save_engine_source(BufferView<EngineSourceProto> engine_source) = 0;
+            [[nodiscard]] virtual UnitResultCode save_engine_snapshot(std::string_view engine_snapshot) = 0;
+            [[nodiscard]] virtual UnitResultCode save_code_cache(u16 file_name_id, std::string_view code_cache) = 0;
+            /* Writes in a transaction of its own so engines replacing a rejected cache never conflict with this one. It only commits while
+             * the worker is still at this version and not deleted, so it can't leave behind a cache that nothing will delete. */
+            [[nodiscard]] virtual UnitResultCode refresh_code_cache(u16 file_name_id, std::string_view code_cache) = 0;
             [[nodiscard]] virtual UnitResultCode commit() = 0;
             [[nodiscard]] virtual UnitResultCode write_cell(const data::CellView &cell_buffer, const std::string_view key) = 0;
             virtual ~ITransaction() = default;
@@ -144,17 +155,28 @@ namespace estate {
             [[nodiscard]] virtual ResultCode<bool> object_instance_exists(const data::ObjectReferenceS &ref) = 0;
             [[nodiscard]] virtual ResultCode<std::optional<Buffer<ObjectInstanceProto>>> maybe_get_object_instance(const data::ObjectReferenceS &ref) = 0;
             [[nodiscard]] virtual ResultCode<std::optional<Buffer<ObjectPropertiesIndexProto>>> maybe_get_object_properties_index(const data::ObjectReferenceS &ref) = 0;
+            // These read in one batch, returning the results in the same order as the refs.
+            [[nodiscard]] virtual ResultCode<std::vector<std::optional<Buffer<ObjectInstanceProto>>>>
+            maybe_get_object_instances(const std::vector<data::ObjectReferenceS> &refs) = 0;
+            [[nodiscard]] virtual ResultCode<std::vector<std::optional<Buffer<ObjectPropertiesIndexProto>>>>
+            maybe_get_object_properties_indexes(const std::vector<data::ObjectReferenceS> &refs) = 0;
             [[nodiscard]] virtual UnitResultCode write_object_instance(const data::ObjectReferenceS &ref, ObjectVersion version, bool deleted) = 0;
             [[nodiscard]] virtual UnitResultCode write_object_properties_index(const data::ObjectReferenceS &ref, const std::optional<std::set<std::string>> &property_names) = 0;
             virtual void undo_get_for_update(const std::string_view key) = 0;
+            // Read-only transactions read from a snapshot without tracking anything, they can't write or be committed.
+            [[nodiscard]] virtual bool is_read_only() const = 0;
         };
 
         struct IDatabase {
             [[maybe_unused]] virtual ResultCode<WorkerVersion, Code> get_worker_version(const LogContext &log_context) = 0;
             [[nodiscard]] virtual ResultCode<ITransactionS, Code> create_transaction(const LogContext &log_context, WorkerVersion worker_version) = 0;
+            [[nodiscard]] virtual ResultCode<ITransactionS, Code> create_read_only_transaction(const LogContext &log_context, WorkerVersion worker_version) = 0;
             [[nodiscard]] virtual ResultCode<Buffer<WorkerIndexProto>, Code> get_worker_index(const LogContext &log_context) = 0;
             [[nodiscard]] virtual ResultCode<Buffer<EngineSourceProto>, Code> get_engine_source(const LogContext &log_context) = 0;
             [[nodiscard]] virtual UnitResultCode mark_as_deleted(const LogContext &log_context) = 0;
+            // How many engines the worker needed at once the last time it ran, 0 when it's never been recorded.
+            [[nodiscard]] virtual ResultCode<u32, Code> get_warm_engine_count(const LogContext &log_context) = 0;
+            [[nodiscard]] virtual UnitResultCode save_warm_engine_count(const LogContext &log_context, u32 warm_engine_count) = 0;
             virtual ~IDatabase() = default;
         };
 
@@ -276,6 +298,12 @@ namespace estate {
 
         struct IObjectRuntime {
             [[nodiscard]] virtual EngineResultCode<CallServiceMethodResult> call_service_method(CallContextS call_context, const CallServiceMethodRequestProto *request) = 0;
+            // Creates an engine for the transaction's worker version and adds it to the worker's pool. False when the pool is full.
+            [[nodiscard]] virtual EngineResultCode<bool> warm_engine(const LogContext &log_context, storage::ITransactionS txn) = 0;
+            // Destroys the engines that have been idle longer than the engine pool's idle timeout.
+            virtual void evict_idle_engines() = 0;
+            // The most engines the worker has had in use at once since the runtime was created.
+            [[nodiscard]] virtual size_t get_peak_engine_count(WorkerId worker_id) = 0;
         };
 
         struct ISetupRuntime {
@@ -288,19 +316,34 @@ namespace estate {
                 std::string icu_location{};
                 std::string external_startup_data{};
                 size_t max_heap_size;
+                // Experimental: create a V8 startup snapshot when a worker version is setup and deserialize engines from it.
+                // V8 aborts the process when it can't serialize the worker's heap, so leave this off outside of testing.
+                bool experimental_use_snapshots{false};
+                // Persist V8 code caches for a worker version's modules and consume them when compiling engines.
+                bool use_code_cache{false};
+                // Terminate requests and module evaluations that run worker code for longer than these, 0 disables the limit.
+                // Keep the wall limit below River's worker_request_timeout_ms so the worker answers before River gives up.
+                u32 max_call_wall_ms{0};
+                u32 max_call_cpu_ms{0};
+                u32 execution_check_interval_ms{10};
                 static JavascriptConfig FromRemote(const LocalConfigurationReader &reader) {
                     return JavascriptConfig{
                             reader.get_string("icu_location", ""),
                             reader.get_string("external_startup_data", ""),
-                            reader.get_u64("max_heap_size")
+                            reader.get_u64("max_heap_size"),
+                            reader.get_bool("experimental_use_snapshots", false),
+                            reader.get_bool("use_code_cache", false),
+                            reader.get_u32("max_call_wall_ms", 0),
+                            reader.get_u32("max_call_cpu_ms", 0),
+                            reader.get_u32("execution_check_interval_ms", 10)
                     };
                 }
             };
             bool is_initialized();
             void initialize(const JavascriptConfig &options);
             void shutdown();
-            ISetupRuntimeS create_setup_runtime();
-            IObjectRuntimeS create_object_runtime(size_t max_heap_size);
+            ISetupRuntimeS create_setup_runtime(size_t max_heap_size);
+            IObjectRuntimeS create_object_runtime(size_t max_heap_size, PoolConfig engine_pool_config = {});
             enum class ClassLookupCode : u8 {
                 WRONG_CLASS_TYPE = 0,
                 NOT_FOUND = 1
@@ -49,8 +49,14 @@
 #define ESTATE_GRAFT_FUNC_FORMAT (ESTATE_GRAFT_FUNC_PREFIX "{0}")
 #define ESTATE_NEW_FUNC_PREFIX ESTATE_INTERNAL_STR(new_)
 #define ESTATE_NEW_FUNC_FORMAT (ESTATE_NEW_FUNC_PREFIX "{0}")
+#define ESTATE_PROTOTYPE_PREFIX ESTATE_INTERNAL_STR(prototype_)
+#define ESTATE_PROTOTYPE_FORMAT (ESTATE_PROTOTYPE_PREFIX "{0}")
 #define ESTATE_PASSTHROUGH_CLASS_NAME_PREFIX ESTATE_INTERNAL_STR(passthrough_)
 #define ESTATE_PASSTHROUGH_CLASS_NAME_FORMAT (ESTATE_PASSTHROUGH_CLASS_NAME_PREFIX "{0}")
 #define ESTATE_OBJECT_PROPERTIES_INDEX_INITIAL_BUFFER_SIZE (1024)
 #define ESTATE_OBJECT_INSTANCE_INITIAL_BUFFER_SIZE (100)
+#define ESTATE_PROPERTY_NAME_BUFFER_SIZE (128) //longer property names are converted on the heap
 #define ESTATE_MODULE_SOURCE_FILE_NAME_FORMAT "worker://{0}/{1}"
+#define ESTATE_FACTORY_MODULE_CODE_CACHE_ID (0) //user files start at file name id 1
+#define ESTATE_ENGINE_SNAPSHOT_LAYOUT (2) //bump when the snapshot data added by CreateSnapshot changes
+#define ESTATE_CELL_CHECKSUM_VERSION (1) //CRC-32C; cells with an older version have their checksum recomputed
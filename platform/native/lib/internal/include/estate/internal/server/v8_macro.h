@@ -92,7 +92,8 @@ t->Set(name, func_templ, V8_RO_FUNC_PROP_ATTR); \
     m->SetSyntheticModuleExport(isolate, name, object).Check(); \
 }
 
-#define V8_COMPILE_MODULE(m, worker_name, code_str, file_name_str) \
+// cached_data may be null, the source takes ownership of it. cache_rejected is set when V8 refused the cached data.
+#define V8_COMPILE_MODULE(m, worker_name, code_str, file_name_str, cached_data, cache_rejected) \
 v8::Local<v8::Module> m; \
 {                                                                \
     const auto origin_name_str = fmt::format(ESTATE_MODULE_SOURCE_FILE_NAME_FORMAT, worker_name, file_name_str);\
@@ -105,10 +106,14 @@ v8::Local<v8::Module> m; \
                                                        v8::Local<v8::Value>(),\
                                                        v8::False(isolate),\
                                                        v8::False(isolate),\
-                                                       v8::True(isolate) /*is ES6 module*/}};\
+                                                       v8::True(isolate) /*is ES6 module*/},\
+                                      cached_data};\
+    const auto compile_options = source.GetCachedData() ?\
+                                 v8::ScriptCompiler::kConsumeCodeCache :\
+                                 v8::ScriptCompiler::kNoCompileOptions;\
     \
     v8::TryCatch try_catch{isolate};\
-    if (!v8::ScriptCompiler::CompileModule(isolate, &source).ToLocal(&m)) {\
+    if (!v8::ScriptCompiler::CompileModule(isolate, &source, compile_options).ToLocal(&m)) {\
         if (try_catch.HasCaught()) {\
             auto ex = create_script_exception(log_context, isolate, try_catch);\
             log_script_exception(log_context, ex);\
@@ -119,4 +124,5 @@ v8::Local<v8::Module> m; \
         log_error(log_context, "Unable to compile module {} for an unknown reason", file_name_str);\
         return Result::Error(Code::ScriptEngine_FailedToCompileModuleUnknownReason);\
     }\
+    cache_rejected = source.GetCachedData() && source.GetCachedData()->rejected;\
 }
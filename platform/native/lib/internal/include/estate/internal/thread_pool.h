@@ -42,6 +42,8 @@ namespace estate {
         [[nodiscard]] std::shared_ptr<boost::asio::io_context> get_context();
         void start();
         void shutdown();
+        /* Waits for the worker threads to exit, call after shutdown and never from one of the pool's threads. */
+        void join();
         template<class F>
         void post(F f) {
             assert(is_started());
@@ -6,31 +6,129 @@
 #include <estate/internal/buffer_pool.h>
 
 namespace estate {
-    BufferPool::BufferPool(BufferPoolConfig config) : config(std::move(config)) {
+    namespace {
+        constexpr size_t get_size_class_size(size_t size_class) {
+            return static_cast<size_t>(BUFFER_POOL_MIN_CLASS_SIZE) << size_class;
+        }
+        constexpr size_t ThreadCachedClassCount = [] {
+            size_t count = 0;
+            while (count < BUFFER_POOL_SIZE_CLASS_COUNT && get_size_class_size(count) <= BUFFER_POOL_THREAD_CACHE_MAX_CLASS_SIZE)
+                ++count;
+            return count;
+        }();
+        //the smallest class that satisfies a request of this size
+        size_t get_size_class_for_request(size_t size) {
+            size_t size_class = 0;
+            while (size_class < BUFFER_POOL_SIZE_CLASS_COUNT - 1 && get_size_class_size(size_class) < size)
+                ++size_class;
+            return size_class;
+        }
+        //the largest class this capacity fully covers, so anything taken from a bin satisfies that class
+        size_t get_size_class_for_capacity(size_t capacity) {
+            size_t size_class = 0;
+            while (size_class < BUFFER_POOL_SIZE_CLASS_COUNT - 1 && get_size_class_size(size_class + 1) <= capacity)
+                ++size_class;
+            return size_class;
+        }
+        //set once the cache is destroyed at thread exit, buffers released after that go to the shared bins
+        thread_local bool thread_cache_destroyed{false};
+        //owned by a single thread so it needs no lock, it only ever holds buffers for one pool at a time
+        struct ThreadCache {
+            u64 pool_id{0};
+            std::array<std::vector<InternalBufferU>, ThreadCachedClassCount> buffers{};
+            void reset(u64 new_pool_id) {
+                for (auto &bin: buffers)
+                    bin.clear();
+                pool_id = new_pool_id;
+            }
+            ~ThreadCache() {
+                thread_cache_destroyed = true;
+            }
+        };
+        thread_local ThreadCache thread_cache{};
+        std::atomic<u64> next_pool_id{1};
+    }
+    BufferPool::BufferPool(BufferPoolConfig config) : config(std::move(config)), id(next_pool_id.fetch_add(1)) {
     }
     int BufferPool::outstanding_lease_count() const {
         return outstanding_leases;
     }
     size_t BufferPool::buffer_queue_count() {
+        size_t count = 0;
+        if (!thread_cache_destroyed && thread_cache.pool_id == id) {
+            for (const auto &bin: thread_cache.buffers)
+                count += bin.size();
+        }
         std::unique_lock<std::mutex> lck(buffers_mutex);
-        return buffers.size();
+        return count + retained_count;
     }
-    InternalBufferU BufferPool::get_internal_buffer(bool &was_reused) {
+    u64 BufferPool::retained_byte_count() {
         std::unique_lock<std::mutex> lck(buffers_mutex);
-        if (buffers.empty()) {
-            auto internal_buffer = std::make_unique<InternalBuffer>();
-            was_reused = false;
-            return std::move(internal_buffer);
-        } else {
-            InternalBufferU internal_buffer = std::move(buffers.front());
-            buffers.pop();
-            was_reused = true;
-            return std::move(internal_buffer);
+        return retained_bytes;
+    }
+    InternalBufferU BufferPool::get_internal_buffer(size_t size_hint, bool &was_reused) {
+        const auto size_class = get_size_class_for_request(size_hint);
+        if (size_class < ThreadCachedClassCount && !thread_cache_destroyed && thread_cache.pool_id == id) {
+            auto &bin = thread_cache.buffers[size_class];
+            if (!bin.empty()) {
+                InternalBufferU internal_buffer = std::move(bin.back());
+                bin.pop_back();
+                was_reused = true;
+                return std::move(internal_buffer);
+            }
+        }
+        {
+            std::unique_lock<std::mutex> lck(buffers_mutex);
+            //a slightly larger buffer beats an allocation, but don't hand out one far bigger than asked for. Without a hint the caller
+            //grows the buffer as it goes so any retained buffer will do, otherwise the larger classes would never be reused.
+            const auto last_class = size_hint == 0 ? BUFFER_POOL_SIZE_CLASS_COUNT - 1 :
+                                    std::min<size_t>(size_class + 2, BUFFER_POOL_SIZE_CLASS_COUNT - 1);
+            for (auto c = size_class; c <= last_class; ++c) {
+                auto &bin = buffers[c];
+                if (bin.empty())
+                    continue;
+                InternalBufferU internal_buffer = std::move(bin.back());
+                bin.pop_back();
+                --retained_count;
+                retained_bytes -= internal_buffer->capacity();
+                was_reused = true;
+                return std::move(internal_buffer);
+            }
         }
+        auto internal_buffer = std::make_unique<InternalBuffer>();
+        internal_buffer->reserve(std::max(size_hint, get_size_class_size(size_class)));
+        was_reused = false;
+        return std::move(internal_buffer);
+    }
+    void BufferPool::release(InternalBufferU buffer) {
+        outstanding_leases.fetch_sub(1);
+        const auto capacity = buffer->capacity();
+        if (capacity > config.max_retained_buffer_size)
+            return;
+        const auto size_class = get_size_class_for_capacity(capacity);
+        if (size_class < ThreadCachedClassCount && config.thread_cache_count > 0 && !thread_cache_destroyed) {
+            if (thread_cache.pool_id != id)
+                thread_cache.reset(id);
+            auto &bin = thread_cache.buffers[size_class];
+            if (bin.size() < config.thread_cache_count) {
+                bin.push_back(std::move(buffer));
+                return;
+            }
+        }
+        std::unique_lock<std::mutex> lck(buffers_mutex);
+        if (retained_count >= config.max_retained_count || retained_bytes + capacity > config.max_retained_bytes)
+            return;
+        buffers[size_class].push_back(std::move(buffer));
+        ++retained_count;
+        retained_bytes += capacity;
     }
     BufferPoolConfig BufferPoolConfig::FromRemote(const LocalConfigurationReader &getter) {
         return BufferPoolConfig{
-                getter.get_bool("clear_on_get", true)
+                getter.get_bool("clear_on_get", true),
+                getter.get_u32("thread_cache_count", BUFFER_POOL_DEFAULT_THREAD_CACHE_COUNT),
+                getter.get_u32("max_retained_count", BUFFER_POOL_DEFAULT_MAX_RETAINED_COUNT),
+                getter.get_u64("max_retained_bytes", BUFFER_POOL_DEFAULT_MAX_RETAINED_BYTES),
+                getter.get_u64("max_retained_buffer_size", BUFFER_POOL_DEFAULT_MAX_RETAINED_BUFFER_SIZE)
         };
     }
     BufferReference::BufferReference(InternalBufferU buffer, BufferPoolS origin) :
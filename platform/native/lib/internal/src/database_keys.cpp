@@ -33,4 +33,12 @@ namespace estate {
         key_str.append(ESTATE_DB_PROPERTY_KEY_SUFFIX);
         return std::move(key_str);
     }
+
+    std::string create_code_cache_key(const WorkerVersion &worker_version, u16 file_name_id) {
+        std::string key_str(ESTATE_DB_CODE_CACHE_KEY_PREFIX);
+        key_str.append(std::to_string(worker_version));
+        key_str.append(ESTATE_DB_KEY_DELIM);
+        key_str.append(std::to_string(file_name_id));
+        return std::move(key_str);
+    }
 }
@@ -0,0 +1,41 @@
+//
+// Originally written by Scott R. Jones.
+// Copyright (c) 2020 Warpdrive Technologies, Inc. All rights reserved.
+//
+
+#include <estate/internal/flatbuffers_util.h>
+
+namespace estate {
+    BufferPoolAllocator::BufferPoolAllocator(BufferPoolS buffer_pool) : _buffer_pool(std::move(buffer_pool)) {
+    }
+    std::optional<Buffer<u8>> *BufferPoolAllocator::find_block(const u8 *p) {
+        for (auto &block: _blocks) {
+            if (block.has_value() && block->as_u8() == p)
+                return &block;
+        }
+        return nullptr;
+    }
+    u8 *BufferPoolAllocator::allocate(size_t size) {
+        for (auto &block: _blocks) {
+            if (block.has_value())
+                continue;
+            block.emplace(_buffer_pool->get_buffer<u8>(size));
+            block->resize(size);
+            return block->as_u8();
+        }
+        assert(false);
+        throw std::bad_alloc();
+    }
+    void BufferPoolAllocator::deallocate(u8 *p, size_t size) {
+        auto block = find_block(p);
+        if (block)
+            block->reset();
+    }
+    Buffer<u8> BufferPoolAllocator::adopt(u8 *p) {
+        auto block = find_block(p);
+        assert(block);
+        Buffer<u8> buffer{std::move(block->value())};
+        block->reset();
+        return std::move(buffer);
+    }
+}
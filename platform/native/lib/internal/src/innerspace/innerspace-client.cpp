@@ -6,6 +6,15 @@
 #include "estate/internal/flatbuffers_util.h"
 
 namespace estate::innerspace {
+//a worker process that can't be reconnected may have been relaunched elsewhere so its endpoint is looked up again
+#define INNERSPACE_WORKER_PROCESS_MIN_BACKOFF_MS (50)
+#define INNERSPACE_WORKER_PROCESS_MAX_BACKOFF_MS (1000)
+#define INNERSPACE_WORKER_PROCESS_MAX_RECONNECT_ATTEMPTS (4)
+//a worker loader that can't be reconnected is replaced by a new client, which resolves its host again
+#define INNERSPACE_WORKER_LOADER_MIN_BACKOFF_MS (50)
+#define INNERSPACE_WORKER_LOADER_MAX_BACKOFF_MS (5000)
+#define INNERSPACE_WORKER_LOADER_MAX_RECONNECT_ATTEMPTS (8)
+
     struct WorkerProcessEndpoint {
         BreakerS worker_process_breaker;
         u16 setup_worker_port;
@@ -28,6 +37,24 @@ namespace estate::innerspace {
         return this->user_port;
     }
 
+    std::string make_worker_process_socket_name(WorkerId worker_id, const char *kind) {
+        return fmt::format("worker-{}-{}", worker_id, kind);
+    }
+    template<typename TReq, typename TResp>
+    const char *get_worker_process_socket_kind();
+    template<>
+    const char *get_worker_process_socket_kind<SetupWorkerRequestProto, SetupWorkerResponseProto>() {
+        return INNERSPACE_SETUP_WORKER_SOCKET_KIND;
+    }
+    template<>
+    const char *get_worker_process_socket_kind<DeleteWorkerRequestProto, DeleteWorkerResponseProto>() {
+        return INNERSPACE_DELETE_WORKER_SOCKET_KIND;
+    }
+    template<>
+    const char *get_worker_process_socket_kind<UserRequestProto, WorkerProcessUserResponseProto>() {
+        return INNERSPACE_USER_SOCKET_KIND;
+    }
+
     class WorkerLoaderClient : public std::enable_shared_from_this<WorkerLoaderClient> {
         BufferPoolS _buffer_pool;
         using InnerspaceT = Innerspace<GetWorkerProcessEndpointRequestProto, GetWorkerProcessEndpointResponseProto>;
@@ -39,21 +66,23 @@ namespace estate::innerspace {
                 _client{std::move(client)}, _buffer_pool{std::move(buffer_pool)} {
         }
 
-        [[nodiscard]] bool is_faulted() const {
-            return _client->is_faulted();
+        [[nodiscard]] bool is_tripped() const {
+            return _client->is_tripped();
         }
 
-        /* Calls Serenity's Worker-Loader process to get and/or load the Worker-Process process and return the ports it's listening on. */
+        /* Calls Serenity's Worker-Loader process to get and/or load the Worker-Process process and return the ports it's listening on.
+         * The deadline is the caller's, so a stalled loader fails the request instead of holding it forever. */
         void async_with_worker_process_endpoint(const LogContext &log_context, WorkerId worker_id,
-                                            std::function<void(ResultCode<WorkerProcessEndpoint>)> response_handler) {
+                                            std::function<void(ResultCode<WorkerProcessEndpoint>)> response_handler,
+                                            std::optional<InnerspaceT::Client::Connection::Deadline> deadline) {
             log_trace(log_context, "Getting worker process endpoint from cache");
 
             {
                 std::lock_guard<std::mutex> lck{_endpoints_mutex};
                 const auto it = _endpoints.find(worker_id);
                 if (it != _endpoints.end()) {
-                    if (it->second.worker_process_breaker->is_faulted()) {
-                        log_warn(log_context, "Replacing previously faulted endpoint for worker {}", worker_id);
+                    if (it->second.worker_process_breaker->is_tripped()) {
+                        log_warn(log_context, "Replacing endpoint for worker {} because it couldn't be reconnected", worker_id);
                         _endpoints.erase(it);
                     } else {
                         log_trace(log_context, "Retrieved worker process endpoint from cache");
@@ -84,7 +113,7 @@ namespace estate::innerspace {
 
             auto conn = conn_r.unwrap();
             std::shared_ptr<WorkerLoaderClient> self = this->shared_from_this();
-            conn->async_send(log_context, buffer.get_view(),
+            conn->async_send(log_context, std::move(buffer),
                              [self, log_context, worker_id, response_handler{std::move(response_handler)}]
                                      (ResultCode<InnerspaceT::ResponseEnvelope> envelope_r) mutable {
                                  using Result = ResultCode<WorkerProcessEndpoint>;
@@ -106,7 +135,11 @@ namespace estate::innerspace {
                                      case GetWorkerProcessEndpointErrorUnionProto::WorkerProcessEndpointProto: {
                                          const auto proto = response.value_as_WorkerProcessEndpointProto();
                                          WorkerProcessEndpoint endpoint{
-                                                 std::make_shared<Breaker>(),
+                                                 std::make_shared<Breaker>(BreakerConfig{
+                                                         std::chrono::milliseconds{INNERSPACE_WORKER_PROCESS_MIN_BACKOFF_MS},
+                                                         std::chrono::milliseconds{INNERSPACE_WORKER_PROCESS_MAX_BACKOFF_MS},
+                                                         INNERSPACE_WORKER_PROCESS_MAX_RECONNECT_ATTEMPTS
+                                                 }),
                                                  proto->setup_worker_port(),
                                                  proto->delete_worker_port(),
                                                  proto->user_port()
@@ -132,7 +165,7 @@ namespace estate::innerspace {
                                      default:
                                          assert(false);
                                  }
-                             });
+                             }, deadline);
         }
     };
     using WorkerLoaderClientS = std::shared_ptr<WorkerLoaderClient>;
@@ -141,7 +174,11 @@ namespace estate::innerspace {
         return std::make_shared<WorkerLoaderClient>(
                 Innerspace<GetWorkerProcessEndpointRequestProto, GetWorkerProcessEndpointResponseProto>::CreateClient(
                         std::move(config), buffer_pool,
-                        io_context, std::make_shared<Breaker>()), buffer_pool);
+                        io_context, std::make_shared<Breaker>(BreakerConfig{
+                                std::chrono::milliseconds{INNERSPACE_WORKER_LOADER_MIN_BACKOFF_MS},
+                                std::chrono::milliseconds{INNERSPACE_WORKER_LOADER_MAX_BACKOFF_MS},
+                                INNERSPACE_WORKER_LOADER_MAX_RECONNECT_ATTEMPTS
+                        })), buffer_pool);
     }
 
     class WorkerLoaderClientFactory : public std::enable_shared_from_this<WorkerLoaderClientFactory> {
@@ -159,9 +196,10 @@ namespace estate::innerspace {
         WorkerLoaderClientS get(const LogContext &log_context) {
             std::shared_ptr<WorkerLoaderClientFactory> self = this->shared_from_this();
             return _worker_loader_client.get_or_replace(
-                    [](const WorkerLoaderClient &c) { return c.is_faulted(); },
+                    [](const WorkerLoaderClient &c) { return c.is_tripped(); },
                     [self, log_context]() {
-                        log_warn(log_context, "Replaced worker-loader client to {}:{} host due to a fault.", self->_config.host, self->_config.port);
+                        log_warn(log_context, "Replaced worker-loader client to {}:{} host because it couldn't be reconnected.", self->_config.host,
+                                 self->_config.port);
                         return create_worker_loader_client(
                                 self->_config,
                                 self->_buffer_pool.get_service(),
@@ -180,18 +218,20 @@ namespace estate::innerspace {
     public:
         explicit WorkerProcessClient(typename InnerspaceT::ClientS client) :
                 _client{std::move(client)} {}
-        [[nodiscard]] bool is_faulted() const {
-            return _client->is_faulted();
+        [[nodiscard]] bool is_tripped() const {
+            return _client->is_tripped();
+        }
+        [[nodiscard]] std::vector<InnerspaceConnectionState> get_connection_states() const {
+            return _client->get_connection_states();
         }
         void async_send(const LogContext &log_context, Buffer<TReq> request_buffer,
-                        typename Innerspace<TReq, TResp>::Client::Connection::ResponseHandler response_handler) {
+                        typename Innerspace<TReq, TResp>::Client::Connection::ResponseHandler response_handler,
+                        std::optional<typename Innerspace<TReq, TResp>::Client::Connection::Deadline> deadline) {
             using ResponseHandlerResult = typename Innerspace<TReq, TResp>::Client::Connection::ResponseHandlerResult;
             auto conn_r = _client->get_connection(log_context);
             if (conn_r) {
                 auto conn = conn_r.unwrap();
-                /*NOTE: The request_buffer is copied synchronously as a result of this call so it's safe to pass a view here so long as we're
-                 * holding onto the reference until after the call is over. */
-                conn->async_send(log_context, request_buffer.get_view(), std::move(response_handler));
+                conn->async_send(log_context, std::move(request_buffer), std::move(response_handler), deadline);
             } else {
                 log_trace(log_context, "When trying to get the connection to worker process received an error instead: {}",
                           get_code_name(conn_r.get_error()));
@@ -212,6 +252,9 @@ namespace estate::innerspace {
         const u8 _connection_count;
         const u32 _max_request_size;
         const u32 _max_response_size;
+        const u32 _max_write_batch_size;
+        const u32 _max_write_batch_count;
+        const std::string _local_socket_dir;
         std::mutex _worker_process_clients_mutex;
         std::unordered_map<WorkerId, Service<WorkerProcessClient<TReq, TResp>>> _worker_process_clients{};
     public:
@@ -221,25 +264,32 @@ namespace estate::innerspace {
                                std::string host,
                                u8 connection_count,
                                u32 max_request_size,
-                               u32 max_response_size) :
+                               u32 max_response_size,
+                               u32 max_write_batch_size = INNERSPACE_DEFAULT_MAX_WRITE_BATCH_SIZE,
+                               u32 max_write_batch_count = INNERSPACE_DEFAULT_MAX_WRITE_BATCH_COUNT,
+                               std::string local_socket_dir = {}) :
                 _worker_loader_client_factory{std::move(worker_loader_client_factory)},
                 _buffer_pool{std::move(buffer_pool)},
                 _io_context{std::move(io_context)},
                 _host{std::move(host)},
                 _connection_count{connection_count},
                 _max_request_size{max_request_size},
-                _max_response_size{max_response_size} {
+                _max_response_size{max_response_size},
+                _max_write_batch_size{max_write_batch_size},
+                _max_write_batch_count{max_write_batch_count},
+                _local_socket_dir{std::move(local_socket_dir)} {
         }
         void async_with_worker_process_client(const LogContext &log_context, WorkerId worker_id,
-                                          std::function<void(ResultCode<WorkerProcessClientS<TReq, TResp>>)> handler) {
+                                          std::function<void(ResultCode<WorkerProcessClientS<TReq, TResp>>)> handler,
+                                          std::optional<std::chrono::steady_clock::time_point> deadline) {
 
             { //if I've already got a WorkerProcess client, handle with that
                 std::lock_guard<std::mutex> lck{_worker_process_clients_mutex};
                 const auto it = _worker_process_clients.find(worker_id);
                 if (it != _worker_process_clients.end()) {
                     WorkerProcessClientS<TReq, TResp> service = it->second.get_service();
-                    if (service->is_faulted()) {
-                        log_warn(log_context, "(in pre check) Removing previously faulted worker process client for worker {}", worker_id);
+                    if (service->is_tripped()) {
+                        log_warn(log_context, "(in pre check) Removing previously tripped worker process client for worker {}", worker_id);
                         _worker_process_clients.erase(it);
                     } else {
                         log_trace(log_context, "Retrieved worker process client from cache");
@@ -272,11 +322,11 @@ namespace estate::innerspace {
                                                                     const auto it = self->_worker_process_clients.find(worker_id);
                                                                     if (it != self->_worker_process_clients.end()) {
                                                                         WorkerProcessClientS<TReq, TResp> service = it->second.get_service();
-                                                                        if (!service->is_faulted()) {
+                                                                        if (!service->is_tripped()) {
                                                                             client = it->second.get_service(); //discard the newly created enpoint because it's already been replaced.
                                                                         } else {
                                                                             log_warn(log_context,
-                                                                                     "(after creation) Replacing previously faulted WorkerProcessClient to worker {}",
+                                                                                     "(after creation) Replacing previously tripped WorkerProcessClient to worker {}",
                                                                                      worker_id);
                                                                             self->_worker_process_clients.erase(it); //remove it if it's faulted
                                                                         }
@@ -288,7 +338,12 @@ namespace estate::innerspace {
                                                                                 endpoint.get_port<TReq, TResp>(),
                                                                                 self->_connection_count,
                                                                                 self->_max_request_size,
-                                                                                self->_max_response_size
+                                                                                self->_max_response_size,
+                                                                                self->_max_write_batch_size,
+                                                                                self->_max_write_batch_count,
+                                                                                self->_local_socket_dir,
+                                                                                make_worker_process_socket_name(worker_id,
+                                                                                                                get_worker_process_socket_kind<TReq, TResp>())
                                                                         };
 
                                                                         auto innerspace_client = Innerspace<TReq, TResp>::CreateClient(client_config,
@@ -309,7 +364,15 @@ namespace estate::innerspace {
                                                             } else {
                                                                 handler(ResultCode<WorkerProcessClientS<TReq, TResp>>::Error(endpoint_r.get_error()));
                                                             }
-                                                        });
+                                                        }, deadline);
+        }
+        void collect_connection_states(std::vector<WorkerProcessConnectionState> &states) {
+            std::lock_guard<std::mutex> lck{_worker_process_clients_mutex};
+            for (const auto &[worker_id, service]: _worker_process_clients) {
+                for (auto &connection_state: service.get_service()->get_connection_states()) {
+                    states.push_back(WorkerProcessConnectionState{worker_id, std::move(connection_state)});
+                }
+            }
         }
     };
     template<typename TReq, typename TResp>
@@ -334,7 +397,10 @@ namespace estate::innerspace {
                     admin_config.host,
                     admin_config.setup_worker_connection_count,
                     admin_config.setup_worker_max_request_size,
-                    admin_config.setup_worker_max_response_size));
+                    admin_config.setup_worker_max_response_size,
+                    admin_config.setup_worker_max_write_batch_size,
+                    admin_config.setup_worker_max_write_batch_count,
+                    admin_config.local_socket_dir));
 
 
             _maybe_delete_factory.emplace(std::make_shared<WorkerProcessClientFactory<DeleteWorkerRequestProto, DeleteWorkerResponseProto>>(
@@ -344,7 +410,10 @@ namespace estate::innerspace {
                     admin_config.host,
                     admin_config.delete_worker_connection_count,
                     admin_config.delete_worker_max_request_size,
-                    admin_config.delete_worker_max_response_size));
+                    admin_config.delete_worker_max_response_size,
+                    admin_config.delete_worker_max_write_batch_size,
+                    admin_config.delete_worker_max_write_batch_count,
+                    admin_config.local_socket_dir));
         }
         /* User commands (River) */
         Impl(BufferPoolS buffer_pool, IoContextS io_context, InnerspaceWorkerLoaderClientConfig worker_loader_config,
@@ -357,22 +426,42 @@ namespace estate::innerspace {
                     user_config.host,
                     user_config.user_connection_count,
                     user_config.user_max_request_size,
-                    user_config.user_max_response_size));
+                    user_config.user_max_response_size,
+                    user_config.user_max_write_batch_size,
+                    user_config.user_max_write_batch_count,
+                    user_config.local_socket_dir));
         }
 
         template<typename TReq, typename TResp>
         WorkerProcessClientFactoryS<TReq, TResp> get_factory();
 
+        std::vector<WorkerProcessConnectionState> get_connection_states() {
+            std::vector<WorkerProcessConnectionState> states{};
+            if (_maybe_setup_factory.has_value())
+                _maybe_setup_factory->get_service()->collect_connection_states(states);
+            if (_maybe_delete_factory.has_value())
+                _maybe_delete_factory->get_service()->collect_connection_states(states);
+            if (_maybe_user_factory.has_value())
+                _maybe_user_factory->get_service()->collect_connection_states(states);
+            return states;
+        }
+
         template<typename TReq, typename TResp>
         using ConnectionT = typename Innerspace<TReq, TResp>::Client::Connection;
 
         template<typename TReq, typename TResp>
         void async_send(const LogContext &log_context, WorkerId worker_id, Buffer<TReq> request_buffer,
-                        typename ConnectionT<TReq, TResp>::ResponseHandler response_handler) {
+                        typename ConnectionT<TReq, TResp>::ResponseHandler response_handler,
+                        std::optional<std::chrono::milliseconds> timeout) {
+            //the deadline starts now so it also covers finding the worker process
+            std::optional<typename ConnectionT<TReq, TResp>::Deadline> deadline{};
+            if (timeout.has_value())
+                deadline = std::chrono::steady_clock::now() + timeout.value();
+
             WorkerProcessClientFactoryS<TReq, TResp> factory = get_factory<TReq, TResp>();
             log_trace(log_context, "Retreived worker process client factory");
             factory->async_with_worker_process_client(log_context, worker_id,
-                                                  [log_context, request_buffer{std::move(request_buffer)}, response_handler{
+                                                  [log_context, deadline, request_buffer{std::move(request_buffer)}, response_handler{
                                                           std::move(response_handler)}]
                                                           (ResultCode<WorkerProcessClientS<TReq, TResp>> worker_process_client_r) {
                                                       if (worker_process_client_r) {
@@ -380,14 +469,14 @@ namespace estate::innerspace {
                                                           WorkerProcessClientS<TReq, TResp> worker_process_client = worker_process_client_r.unwrap();
                                                           WorkerProcessClient<TReq, TResp> &worker_process_client_ = *worker_process_client;
                                                           worker_process_client_.async_send(log_context, request_buffer,
-                                                                                        std::move(response_handler));
+                                                                                        std::move(response_handler), deadline);
                                                       } else {
                                                           log_trace(log_context, "Received error {} instead of worker process client",
                                                                     get_code_name(worker_process_client_r.get_error()));
                                                           response_handler(ConnectionT<TReq, TResp>::ResponseHandlerResult::Error(
                                                                   worker_process_client_r.get_error()));
                                                       }
-                                                  });
+                                                  }, deadline);
         }
     };
 
@@ -424,20 +513,28 @@ namespace estate::innerspace {
     }
 
     void InnerspaceClient::async_send(const LogContext &log_context, WorkerId worker_id, Buffer<UserRequestProto> request_buffer,
-                                      Innerspace<UserRequestProto, WorkerProcessUserResponseProto>::Client::Connection::ResponseHandler response_handler) {
+                                      Innerspace<UserRequestProto, WorkerProcessUserResponseProto>::Client::Connection::ResponseHandler response_handler,
+                                      std::optional<std::chrono::milliseconds> timeout) {
         assert(_impl);
-        _impl->async_send<UserRequestProto, WorkerProcessUserResponseProto>(log_context, worker_id, std::move(request_buffer), std::move(response_handler));
+        _impl->async_send<UserRequestProto, WorkerProcessUserResponseProto>(log_context, worker_id, std::move(request_buffer), std::move(response_handler),
+                                                                            timeout);
     }
     void InnerspaceClient::async_send(const LogContext &log_context, WorkerId worker_id, Buffer<SetupWorkerRequestProto> request_buffer,
-                                      Innerspace<SetupWorkerRequestProto, SetupWorkerResponseProto>::Client::Connection::ResponseHandler response_handler) {
+                                      Innerspace<SetupWorkerRequestProto, SetupWorkerResponseProto>::Client::Connection::ResponseHandler response_handler,
+                                      std::optional<std::chrono::milliseconds> timeout) {
         assert(_impl);
         _impl->async_send<SetupWorkerRequestProto, SetupWorkerResponseProto>(log_context, worker_id, std::move(request_buffer),
-                                                                         std::move(response_handler));
+                                                                         std::move(response_handler), timeout);
     }
     void InnerspaceClient::async_send(const LogContext &log_context, WorkerId worker_id, Buffer<DeleteWorkerRequestProto> request_buffer,
-                                      Innerspace<DeleteWorkerRequestProto, DeleteWorkerResponseProto>::Client::Connection::ResponseHandler response_handler) {
+                                      Innerspace<DeleteWorkerRequestProto, DeleteWorkerResponseProto>::Client::Connection::ResponseHandler response_handler,
+                                      std::optional<std::chrono::milliseconds> timeout) {
         assert(_impl);
         _impl->async_send<DeleteWorkerRequestProto, DeleteWorkerResponseProto>(log_context, worker_id, std::move(request_buffer),
-                                                                           std::move(response_handler));
+                                                                           std::move(response_handler), timeout);
+    }
+    std::vector<WorkerProcessConnectionState> InnerspaceClient::get_connection_states() {
+        assert(_impl);
+        return _impl->get_connection_states();
     }
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 
 #include <estate/internal/innerspace/innerspace.h>
 
+#include <random>
+
 namespace estate {
     ResultCode<ResolvedEndpoint, Code> resolve_endpoint(const std::string &host, u16 port, IoContextS io_context) {
         using Result = ResultCode<ResolvedEndpoint, Code>;
@@ -26,12 +28,96 @@ namespace estate {
 
         return Result::Ok(endpoint);
     }
+    const char *get_breaker_state_name(BreakerState state) {
+        switch (state) {
+            case BreakerState::Closed:
+                return "Closed";
+            case BreakerState::Open:
+                return "Open";
+            case BreakerState::HalfOpen:
+                return "HalfOpen";
+            case BreakerState::Tripped:
+                return "Tripped";
+        }
+        return "Unknown";
+    }
     bool Breaker::fault() {
-        bool prev{false};
-        return _fault.compare_exchange_strong(prev, true);
+        std::lock_guard<std::mutex> lck{_mutex};
+
+        const auto state = _state.load();
+        if (state == BreakerState::Open || state == BreakerState::Tripped)
+            return false;
+
+        ++_faults;
+        _probe_started_at.reset();
+
+        if (_config.max_attempts > 0 && _faults >= _config.max_attempts) {
+            _state = BreakerState::Tripped;
+            return true;
+        }
+
+        //full backoff doubles each consecutive fault, then half of it is jittered so reconnects from many clients spread out
+        const auto shift = std::min<u32>(_faults - 1, 16);
+        const auto backoff = std::min(_config.max_backoff, _config.min_backoff * (1 << shift));
+        thread_local std::minstd_rand random{std::random_device{}()};
+        std::uniform_int_distribution<i64> jitter{backoff.count() / 2, std::max<i64>(backoff.count(), 1)};
+        _retry_delay = std::chrono::milliseconds{jitter(random)};
+
+        _state = BreakerState::Open;
+        return true;
+    }
+    void Breaker::half_open() {
+        std::lock_guard<std::mutex> lck{_mutex};
+        if (_state == BreakerState::Open) {
+            _probe_started_at.reset();
+            _state = BreakerState::HalfOpen;
+        }
+    }
+    std::optional<u64> Breaker::try_acquire() {
+        const auto state = _state.load();
+        if (state == BreakerState::Closed)
+            return 0;
+        if (state != BreakerState::HalfOpen)
+            return std::nullopt;
+
+        std::lock_guard<std::mutex> lck{_mutex};
+        if (_state != BreakerState::HalfOpen) {
+            if (_state == BreakerState::Closed)
+                return 0;
+            return std::nullopt;
+        }
+
+        //a probe that never got an answer doesn't hold the breaker half-open forever
+        const auto now = std::chrono::steady_clock::now();
+        if (_probe_started_at.has_value() && now - _probe_started_at.value() < _config.max_backoff)
+            return std::nullopt;
+
+        _probe_started_at = now;
+        return ++_probe;
+    }
+    void Breaker::succeed(u64 probe) {
+        if (_state.load() == BreakerState::Closed)
+            return;
+        std::lock_guard<std::mutex> lck{_mutex};
+        if (_state == BreakerState::HalfOpen && probe == _probe) {
+            _faults = 0;
+            _probe_started_at.reset();
+            _state = BreakerState::Closed;
+        }
+    }
+    std::chrono::milliseconds Breaker::get_retry_delay() {
+        std::lock_guard<std::mutex> lck{_mutex};
+        return _retry_delay;
     }
     bool Breaker::is_faulted() const {
-        return _fault;
+        const auto state = _state.load();
+        return state == BreakerState::Open || state == BreakerState::Tripped;
+    }
+    bool Breaker::is_tripped() const {
+        return _state == BreakerState::Tripped;
+    }
+    BreakerState Breaker::get_state() const {
+        return _state;
     }
     std::size_t InnerspaceClientEndpoint::Hasher::operator()(const InnerspaceClientEndpoint &client_endpoint) const {
         using boost::hash_value;
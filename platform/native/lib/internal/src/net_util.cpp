@@ -8,6 +8,7 @@
 #include <estate/runtime/result.h>
 
 #include <ifaddrs.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <string>
@@ -56,4 +57,22 @@ namespace estate {
     Endpoint make_endpoint(std::string address, u16 port) {
         return boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address(address), port);
     }
+    std::string make_local_socket_path(const std::string &socket_dir, const std::string &name) {
+        return socket_dir + "/innerspace-" + name + ".sock";
+    }
+    std::string make_local_socket_path(const std::string &socket_dir, u16 port) {
+        return make_local_socket_path(socket_dir, std::to_string(port));
+    }
+    StreamEndpoint make_local_endpoint(const std::string &socket_dir, const std::string &name) {
+        return boost::asio::local::stream_protocol::endpoint(make_local_socket_path(socket_dir, name));
+    }
+    StreamEndpoint make_local_endpoint(const std::string &socket_dir, u16 port) {
+        return make_local_endpoint(socket_dir, std::to_string(port));
+    }
+    std::optional<std::string> get_local_socket_path(const StreamEndpoint &endpoint) {
+        if (endpoint.protocol().family() != AF_UNIX)
+            return std::nullopt;
+        const auto *address = reinterpret_cast<const sockaddr_un *>(endpoint.data());
+        return std::string(address->sun_path);
+    }
 }
\ No newline at end of file
@@ -71,7 +71,7 @@ namespace estate::outerspace {
             return Result::Error();
         }
 
-        Envelope_ envelope = _buffer_pool->get_envelope<SendHeader, void, u32>();
+        Envelope_ envelope = _buffer_pool->get_envelope<SendHeader, void, u32>(send_buffer.size());
 
         envelope.resize_for_payload(send_buffer.size());
 
@@ -228,7 +228,7 @@ namespace estate::outerspace {
                     RequestId request_id = header->request_id;
 
                     //Copy the buffer out of the temporary buffer
-                    auto buffer = self->_buffer_pool->template get_buffer<UserRequestProto>();
+                    auto buffer = self->_buffer_pool->template get_buffer<UserRequestProto>(self->_read_buffer.get_payload_size());
                     buffer.resize(self->_read_buffer.get_payload_size());
                     std::memcpy(buffer.as_u8(), self->_read_buffer.get_payload_raw(), self->_read_buffer.get_payload_size());
 
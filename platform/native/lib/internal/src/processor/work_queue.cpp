@@ -0,0 +1,83 @@
+//
+// Created by scott on 10/17/2026.
+//
+
+#include "estate/internal/processor/work_queue.h"
+
+#include <cassert>
+
+namespace estate {
+    WorkQueue::WorkQueue(WorkQueueConfig config) : _config(config) {
+        if (_config.num_threads > 0) {
+            _thread_pool = std::make_unique<ThreadPool>(ThreadPoolConfig{_config.num_threads});
+            _thread_pool->start();
+        }
+    }
+    WorkQueue::~WorkQueue() {
+        shutdown();
+    }
+    bool WorkQueue::is_inline() const {
+        return !_thread_pool;
+    }
+    void WorkQueue::record_enqueued(u32 depth) {
+        auto seen = _max_depth_seen.load();
+        while (depth > seen && !_max_depth_seen.compare_exchange_weak(seen, depth));
+    }
+    void WorkQueue::record_wait(std::chrono::steady_clock::duration wait) {
+        const u64 wait_us = std::chrono::duration_cast<std::chrono::microseconds>(wait).count();
+        _total_wait_us.fetch_add(wait_us);
+        auto seen = _max_wait_us.load();
+        while (wait_us > seen && !_max_wait_us.compare_exchange_weak(seen, wait_us));
+        if (wait_us > static_cast<u64>(_config.slow_wait_ms) * 1000)
+            sys_log_warn("Work waited {}ms in the queue, {} still waiting", wait_us / 1000, _depth.load());
+    }
+    void WorkQueue::post_next_ordered(const std::string &key) {
+        std::unique_lock<std::mutex> lck(_ordered_mutex);
+        auto it = _ordered.find(key);
+        assert(it != _ordered.end());
+        if (it->second.empty() || _stopped) {
+            if (_thread_pool)
+                _depth.fetch_sub(static_cast<u32>(it->second.size()));
+            _ordered.erase(it); //anything still waiting is dropped at shutdown
+            return;
+        }
+        auto next = std::move(it->second.front());
+        it->second.pop_front();
+        auto run = [this, key, next{std::move(next)}]() mutable {
+            next();
+            post_next_ordered(key);
+        };
+        if (_thread_pool) {
+            //it was admitted and counted when it was parked so it never runs inline, and it's queued under the lock so shutdown can't
+            //stop the pool first
+            enqueue(_depth.load(), std::move(run));
+            return;
+        }
+        lck.unlock();
+        run();
+    }
+    void WorkQueue::shutdown() {
+        if (!_thread_pool || !_thread_pool->is_started())
+            return;
+        {
+            std::unique_lock<std::mutex> lck(_ordered_mutex);
+            _stopped = true;
+        }
+        _thread_pool->shutdown();
+        _thread_pool->join();
+        const auto stats = get_stats();
+        sys_log_info("Work queue shut down after running {} items ({} inline, {} waited for their key), max depth {}, max wait {}us",
+                     stats.executed, stats.ran_inline, stats.ordered_waits, stats.max_depth_seen, stats.max_wait.count());
+    }
+    WorkQueueStats WorkQueue::get_stats() const {
+        return WorkQueueStats{
+                _depth.load(),
+                _max_depth_seen.load(),
+                _executed.load(),
+                _ran_inline.load(),
+                std::chrono::microseconds{_total_wait_us.load()},
+                std::chrono::microseconds{_max_wait_us.load()},
+                _ordered_waits.load()
+        };
+    }
+}
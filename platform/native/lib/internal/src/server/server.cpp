@@ -14,6 +14,7 @@
 #include "estate/internal/stopwatch.h"
 #include "estate/internal/buffer_pool.h"
 #include "estate/internal/file_util.h"
+#include "estate/internal/checksum.h"
 #include "estate/internal/deps/boost.h"
 
 #include <estate/runtime/buffer_view.h>
@@ -25,12 +26,17 @@
 #include <iostream>
 #include <utility>
 #include <filesystem>
+#include <thread>
+#include <list>
+#include <condition_variable>
+#include <pthread.h>
+#include <time.h>
 
 #include "server_rc.inl"
 
 namespace estate {
     namespace data {
-        void _get_crc(boost::crc_32_type &crc, const ValueProto *value) {
+        void _get_crc(Crc32c &crc, const ValueProto *value) {
             const auto type = value->value_type();
 
             crc.process_byte((u8) type);
@@ -145,10 +151,17 @@ namespace estate {
             }
         }
         u32 get_crc(const ValueProto *value) {
-            boost::crc_32_type crc;
+            Crc32c crc;
             _get_crc(crc, value);
             return crc.checksum();
         }
+        // The cell's checksum as get_crc computes it. Cells written before ESTATE_CELL_CHECKSUM_VERSION are recomputed.
+        template<typename C> //Cell or CellView
+        u32 get_cell_checksum(const C &cell) {
+            if (cell->checksum_version() == ESTATE_CELL_CHECKSUM_VERSION)
+                return cell->checksum();
+            return get_crc(cell->value_bytes_nested_root());
+        }
 
         struct ObjectReferenceWrapper {
             const ObjectReferenceS ref;
@@ -336,19 +349,46 @@ namespace estate {
 
         class ScriptValue {
             std::optional<v8::Global<v8::Value>> _maybe_script_value{};
+            bool _dirty{false}; //assigned or deleted since it was loaded or last flushed
+            bool _exposed{false}; //a container script holds a reference to, it may have been mutated in place
+            // Objects and arrays can change without going through the property interceptors. References to Data and
+            // Services (wrapped objects) can't, their own properties are tracked separately.
+            static bool is_mutable_container(const v8::Local<v8::Value> &value) {
+                return value->IsObject() && v8::Local<v8::Object>::Cast(value)->InternalFieldCount() == 0;
+            }
         public:
             // No preconditions.
             void set_unknown() {
                 _maybe_script_value.reset();
+                _dirty = false;
+                _exposed = false;
             }
             // No preconditions.
             // Returns whether the value existed previously.
             bool erase() {
                 bool previously_existed = known() && exists();
                 _maybe_script_value.emplace(); //sets Global to IsEmpty so known() == true
+                _dirty = true;
+                _exposed = false;
                 return previously_existed;
             }
             // No preconditions.
+            // Whether the value may differ from the current cell and needs to be serialized when flushed.
+            [[nodiscard]] constexpr bool is_dirty() const {
+                return _dirty || _exposed;
+            }
+            // No preconditions.
+            // Called once the value has been serialized into the current cell. An exposed container stays dirty.
+            void set_flushed() {
+                _dirty = false;
+            }
+            // No preconditions.
+            // Called when the value is handed to script.
+            void set_exposed(const v8::Local<v8::Value> &value) {
+                if (is_mutable_container(value))
+                    _exposed = true;
+            }
+            // No preconditions.
             [[nodiscard]] constexpr bool known() const {
                 return _maybe_script_value.has_value();
             }
@@ -381,6 +421,8 @@ namespace estate {
                 if (value->IsUndefined()) {
                     erase();
                 } else {
+                    _dirty = true;
+                    _exposed = is_mutable_container(value);
                     if (_maybe_script_value.has_value()) {
                         _maybe_script_value->Reset(call_context->get_isolate(), value);
                     } else {
@@ -432,29 +474,28 @@ namespace estate {
 
                 const auto value = script_value.get_script_value(call_context);
 
-                //Serialize the Value
-                fbs::Builder value_builder{};
+                //Serialize the Value straight into the builder the Cell is built in
+                PooledBuilder builder{call_context->get_buffer_pool()};
                 ValueUnionProto type;
                 auto value_root_r = engine::javascript::serialize(call_context->get_log_context(), isolate,
-                                                                  value_builder, value, type, maybe_tracker);
+                                                                  builder, value, type, maybe_tracker);
                 if (!value_root_r)
                     return Result::Error(value_root_r.get_error());
                 auto value_root = value_root_r.unwrap();
-                value_builder.Finish(value_root);
+                builder.Finish(value_root);
 
                 //Calculate the new checksum
-                const auto new_checksum = get_crc(flatbuffers::GetRoot<ValueProto>(value_builder.GetBufferPointer()));
+                const auto new_checksum = get_crc(flatbuffers::GetRoot<ValueProto>(builder.GetBufferPointer()));
 
-                if (exists() && get_cell()->checksum() == new_checksum) {
+                if (exists() && get_cell_checksum(get_cell()) == new_checksum) {
                     return Result::Ok(false); // checksum is still the same, no changes.
                 }
 
-                //Serialize the Cell
-                fbs::Builder cell_builder{value_builder.GetSize()};
-                auto value_vec_off = cell_builder.CreateVector(value_builder.GetBufferPointer(), value_builder.GetSize());
-                auto cell_root = CreateCellProto(cell_builder, new_checksum, value_vec_off);
+                //Wrap the Value in the Cell, its bytes become the Cell's value_bytes in place
+                auto value_vec_off = nest_finished_buffer(builder);
+                auto cell_root = CreateCellProto(builder, new_checksum, value_vec_off, ESTATE_CELL_CHECKSUM_VERSION);
 
-                _cell_state->set_current(finish_and_copy_to_buffer(cell_builder, call_context->get_buffer_pool(), cell_root));
+                _cell_state->set_current(finish_to_buffer(builder, cell_root));
 
                 return Result::Ok(true);
             }
@@ -481,6 +522,9 @@ namespace estate {
                     _maybe_script_value.emplace(isolate, handle_scope.Escape(value));
                 }
             }
+            //freshly loaded so it matches the current cell
+            _dirty = false;
+            _exposed = false;
             return Result::Ok();
         }
 
@@ -511,7 +555,7 @@ namespace estate {
                     WORKED_OR_RETURN(txn->delete_value(_key));
                 } else {
                     const auto current_cell = current.get_cell();
-                    if (exists() && current_cell->checksum() == get_cell()->checksum())
+                    if (exists() && get_cell_checksum(current_cell) == get_cell_checksum(get_cell()))
                         return Result::Ok(false); //no changes
                     auto txn = call_context->get_transaction();
                     WORKED_OR_RETURN(txn->write_cell(current_cell, _key));
@@ -522,7 +566,7 @@ namespace estate {
         };
 
         std::optional<i32> maybe_get_checksum(const std::optional<Cell> &maybe_cell) {
-            return maybe_cell.has_value() ? std::make_optional<i32>(maybe_cell.value()->checksum()) : std::nullopt;
+            return maybe_cell.has_value() ? std::make_optional<i32>(get_cell_checksum(maybe_cell.value())) : std::nullopt;
         }
 
         // Class that encapsulates reading/writing individual object fields (properties)
@@ -589,7 +633,9 @@ namespace estate {
                 if (!_script_value.known()) {
                     WORKED_OR_RETURN(_script_value.apply(_call_context, _current_value));
                 }
-                return Result::Ok(_script_value.get_script_value(_call_context));
+                auto value = _script_value.get_script_value(_call_context);
+                _script_value.set_exposed(value);
+                return Result::Ok(value);
             }
             // Sets the script value.
             // No preconditions.
@@ -609,7 +655,13 @@ namespace estate {
                 if (!_script_value.known()) {
                     return Result::Ok(false); //nothing to flush
                 }
-                return _current_value.apply(_call_context, _script_value, maybe_tracker);
+                // A clean value can't have changed, but a graph save still serializes it to find the Data it references.
+                if (!_script_value.is_dirty() && !maybe_tracker.has_value()) {
+                    return Result::Ok(false);
+                }
+                UNWRAP_OR_RETURN(changed, _current_value.apply(_call_context, _script_value, maybe_tracker));
+                _script_value.set_flushed();
+                return Result::Ok(changed);
             }
             // Save's the state to the database if there was a change and replaces the saved state if necessary.
             // No preconditions.
@@ -630,20 +682,40 @@ namespace estate {
                 using Result = ResultCode<PropertyS>;
                 auto key = create_property_key(ref->class_id, ref->get_primary_key(), name);
                 UNWRAP_OR_RETURN(maybe_cell, call_context->get_transaction()->maybe_get_cell(key));
-
+                return Result::Ok(Create(std::move(call_context), std::move(name), std::move(key), std::move(maybe_cell)));
+            }
+            // Same as LoadOrCreate for each object reference and name, but reads all of the cells in one batch.
+            static ResultCode<std::vector<PropertyS>>
+            LoadOrCreateMany(const engine::CallContextS &call_context, std::vector<std::pair<ObjectReferenceS, std::string>> names) {
+                using Result = ResultCode<std::vector<PropertyS>>;
+                std::vector<std::string> keys{};
+                keys.reserve(names.size());
+                for (const auto &[ref, name]: names)
+                    keys.push_back(create_property_key(ref->class_id, ref->get_primary_key(), name));
+                UNWRAP_OR_RETURN(maybe_cells, call_context->get_transaction()->maybe_get_cells(keys));
+                assert(maybe_cells.size() == names.size());
+
+                std::vector<PropertyS> properties{};
+                properties.reserve(names.size());
+                for (size_t i = 0; i < names.size(); ++i)
+                    properties.push_back(Create(call_context, std::move(names[i].second), std::move(keys[i]), std::move(maybe_cells[i])));
+                return Result::Ok(std::move(properties));
+            }
+        private:
+            static PropertyS Create(engine::CallContextS call_context, std::string name, std::string key, std::optional<data::Cell> maybe_cell) {
                 std::optional<i32> maybe_original_checksum{};
                 CellStateS cell_state;
                 if (maybe_cell.has_value()) {
                     //Existing
-                    maybe_original_checksum = std::make_optional<i32>(maybe_cell.value()->checksum());
+                    maybe_original_checksum = std::make_optional<i32>(get_cell_checksum(maybe_cell.value()));
                     cell_state = std::make_shared<CellState>(std::move(maybe_cell.value()));
                 } else {
                     //New (note: exists() will return false initially)
                     cell_state = std::make_shared<CellState>();
                 }
 
-                return Result::Ok(std::make_shared<Property>(std::move(call_context), std::move(name),
-                                                             std::move(key), maybe_original_checksum, std::move(cell_state)));
+                return std::make_shared<Property>(std::move(call_context), std::move(name),
+                                                  std::move(key), maybe_original_checksum, std::move(cell_state));
             }
         };
 
@@ -694,19 +766,57 @@ namespace estate {
             }
 
             // No preconditions.
-            [[nodiscard]] ResultCode<PropertyS> get_property(const ObjectReferenceS &ref, std::string name) {
+            [[nodiscard]] ResultCode<PropertyS> get_property(const ObjectReferenceS &ref, std::string_view name) {
                 using Result = ResultCode<PropertyS>;
 
                 const auto it = _property_cache.find(name);
                 if (it != _property_cache.end())
                     return Result::Ok(it->second); //Found, return cached
 
-                UNWRAP_OR_RETURN(property, PropertyFactory::LoadOrCreate(_call_context, ref, std::move(name)));
+                UNWRAP_OR_RETURN(property, PropertyFactory::LoadOrCreate(_call_context, ref, std::string{name}));
                 _property_names.emplace(property->get_name());
                 _property_cache[property->get_name_view()] = property;
                 return Result::Ok(std::move(property));
             }
 
+            // No preconditions.
+            [[nodiscard]] std::vector<std::string> get_uncached_property_names(const std::set<std::string> &names) const {
+                std::vector<std::string> uncached{};
+                for (const auto &name: names) {
+                    if (!_property_cache.contains(name))
+                        uncached.push_back(name);
+                }
+                return uncached;
+            }
+
+            // Precondition: The property isn't cached yet.
+            void cache_property(PropertyS property) {
+                assert(!_property_cache.contains(property->get_name_view()));
+                _property_names.emplace(property->get_name());
+                _property_cache[property->get_name_view()] = std::move(property);
+            }
+
+            // No preconditions.
+            // Loads the properties that aren't cached yet with a single batched read, so the get_property calls that follow are cache hits.
+            [[nodiscard]] UnitResultCode load_properties(const ObjectReferenceS &ref, const std::set<std::string> &names) {
+                using Result = UnitResultCode;
+
+                std::vector<std::pair<ObjectReferenceS, std::string>> uncached{};
+                for (auto &name: get_uncached_property_names(names))
+                    uncached.emplace_back(ref, std::move(name));
+                if (uncached.empty())
+                    return Result::Ok();
+                if (uncached.size() == 1) {
+                    WORKED_OR_RETURN(get_property(ref, uncached.front().second));
+                    return Result::Ok();
+                }
+
+                UNWRAP_OR_RETURN(properties, PropertyFactory::LoadOrCreateMany(_call_context, std::move(uncached)));
+                for (auto &property: properties)
+                    cache_property(std::move(property));
+                return Result::Ok();
+            }
+
             // No preconditions.
             [[nodiscard]] const std::unordered_map<std::string_view, PropertyS> &get_property_cache() const {
                 return _property_cache;
@@ -887,25 +997,24 @@ namespace estate {
 
                 // Get the property names if they exist.
                 UNWRAP_OR_RETURN(maybe_object_index_properties, txn->maybe_get_object_properties_index(ref));
-                std::optional<std::set<std::string>> maybe_property_names{};
+                return Result::Ok(Create(std::move(call_context), std::move(ref), object_instance, maybe_object_index_properties));
+            }
+            [[nodiscard]] static ObjectS Create(engine::CallContextS call_context, ObjectReferenceS ref,
+                                                const Buffer<ObjectInstanceProto> &object_instance,
+                                                const std::optional<Buffer<ObjectPropertiesIndexProto>> &maybe_object_index_properties) {
+                std::set<std::string> property_names{};
                 if (maybe_object_index_properties.has_value()) {
-                    const auto object_index_properties = std::move(maybe_object_index_properties.value());
+                    const auto &object_index_properties = maybe_object_index_properties.value();
                     if (object_index_properties->properties() && object_index_properties->properties()->size() > 0) {
-                        maybe_property_names.emplace();
                         for (auto it: *object_index_properties->properties()) {
-                            maybe_property_names->insert(it->str());
+                            property_names.insert(it->str());
                         }
                     }
                 }
 
                 const auto version = object_instance->version();
                 auto handle = make_object_handle(std::move(ref), version, version);
-
-                if (maybe_property_names.has_value()) {
-                    return Result::Ok(std::make_shared<Object>(std::move(call_context), std::move(handle), std::move(maybe_property_names.value())));
-                } else {
-                    return Result::Ok(std::make_shared<Object>(std::move(call_context), std::move(handle), std::set<std::string>{}));
-                }
+                return std::make_shared<Object>(std::move(call_context), std::move(handle), std::move(property_names));
             }
         public:
             [[nodiscard]] static ResultCode<std::optional<ObjectS>>
@@ -915,6 +1024,44 @@ namespace estate {
             [[nodiscard]] static ResultCode<std::optional<ObjectS>> MaybeLoadFromHandle(engine::CallContextS call_context, ObjectHandleS handle) {
                 return MaybeLoad(std::move(call_context), handle->get_reference(), handle->get_version());
             }
+            // Same as MaybeLoadFromRef without creating, but reads all of the instances and then all of the indexes in one batch each.
+            [[nodiscard]] static ResultCode<std::vector<std::optional<ObjectS>>>
+            MaybeLoadManyFromRefs(const engine::CallContextS &call_context, const std::vector<ObjectReferenceS> &refs) {
+                using Result = ResultCode<std::vector<std::optional<ObjectS>>>;
+
+                auto txn = call_context->get_transaction();
+
+                UNWRAP_OR_RETURN(maybe_object_instances, txn->maybe_get_object_instances(refs));
+                std::vector<ObjectReferenceS> found_refs{};
+                for (size_t i = 0; i < refs.size(); ++i) {
+                    const auto &maybe_object_instance = maybe_object_instances[i];
+                    if (!maybe_object_instance.has_value())
+                        continue;
+                    if ((data::ObjectType) maybe_object_instance.value()->type() != refs[i]->type)
+                        return Result::Error(Code::Datastore_TypeMismatch);
+                    if (maybe_object_instance.value()->deleted())
+                        return Result::Error(Code::Datastore_ObjectDeleted);
+                    found_refs.push_back(refs[i]);
+                }
+
+                std::vector<std::optional<Buffer<ObjectPropertiesIndexProto>>> maybe_object_index_properties{};
+                if (!found_refs.empty()) {
+                    ASSIGN_OR_RETURN(maybe_object_index_properties, txn->maybe_get_object_properties_indexes(found_refs));
+                }
+
+                std::vector<std::optional<ObjectS>> maybe_objects{};
+                maybe_objects.reserve(refs.size());
+                size_t found_index{0};
+                for (size_t i = 0; i < refs.size(); ++i) {
+                    if (!maybe_object_instances[i].has_value()) {
+                        maybe_objects.emplace_back(std::nullopt);
+                        continue;
+                    }
+                    maybe_objects.emplace_back(Create(call_context, refs[i], maybe_object_instances[i].value(),
+                                                      maybe_object_index_properties[found_index++]));
+                }
+                return Result::Ok(std::move(maybe_objects));
+            }
             [[nodiscard]] static ResultCode<ObjectS> CreateNew(engine::CallContextS call_context, ObjectReferenceS ref) {
                 using Result = ResultCode<ObjectS>;
                 auto txn = call_context->get_transaction();
@@ -996,10 +1143,22 @@ namespace estate {
                 return _permanent.get_property_names();
             }
             // No preconditions.
-            [[nodiscard]] ResultCode<PropertyS> get_property(std::string property_name) {
+            [[nodiscard]] ResultCode<PropertyS> get_property(std::string_view property_name) {
                 return _current.get_property(get_reference(), property_name);
             }
             // No preconditions.
+            [[nodiscard]] UnitResultCode load_properties(const std::set<std::string> &property_names) {
+                return _current.load_properties(get_reference(), property_names);
+            }
+            // No preconditions.
+            [[nodiscard]] std::vector<std::string> get_uncached_property_names(const std::set<std::string> &property_names) const {
+                return _current.get_uncached_property_names(property_names);
+            }
+            // Precondition: The property isn't cached yet.
+            void cache_property(PropertyS property) {
+                _current.cache_property(std::move(property));
+            }
+            // No preconditions.
             bool erase_property(PropertyS &property, bool script_value_only) {
                 return _current.erase_property(property, script_value_only);
             }
@@ -1149,6 +1308,65 @@ namespace estate {
                     return Result::Ok(std::move(maybe_object));
                 }
             }
+            // Same as maybe_resolve without creating, but the objects that aren't cached are loaded in one batch.
+            [[nodiscard]] ResultCode<std::vector<std::optional<ObjectS>>> maybe_resolve_many(const std::vector<ObjectReferenceS> &refs) {
+                using Result = ResultCode<std::vector<std::optional<ObjectS>>>;
+
+                std::vector<std::optional<ObjectS>> maybe_objects(refs.size());
+                std::vector<ObjectReferenceS> uncached_refs{};
+                std::unordered_map<ObjectReferenceWrapper, size_t, ObjectReferenceWrapper::Hasher> uncached_indexes{};
+                std::vector<size_t> load_indexes(refs.size()); //into uncached_refs, for the refs that weren't cached
+                for (size_t i = 0; i < refs.size(); ++i) {
+                    if (_cached) {
+                        auto maybe_handle = maybe_resolve_reference(refs[i]);
+                        if (maybe_handle) {
+                            maybe_objects[i] = maybe_resolve_handle(maybe_handle.value());
+                            if (maybe_objects[i])
+                                continue;
+                        }
+                    }
+                    const auto[it, inserted] = uncached_indexes.emplace(ObjectReferenceWrapper{refs[i]}, uncached_refs.size());
+                    if (inserted)
+                        uncached_refs.push_back(refs[i]);
+                    load_indexes[i] = it->second;
+                }
+                if (uncached_refs.empty())
+                    return Result::Ok(std::move(maybe_objects));
+
+                UNWRAP_OR_RETURN(loaded, ObjectFactory::MaybeLoadManyFromRefs(_call_context, uncached_refs));
+                if (_cached) {
+                    for (const auto &maybe_object: loaded) {
+                        if (maybe_object)
+                            cache(maybe_object.value());
+                    }
+                }
+                for (size_t i = 0; i < refs.size(); ++i) {
+                    if (!maybe_objects[i])
+                        maybe_objects[i] = loaded[load_indexes[i]];
+                }
+                return Result::Ok(std::move(maybe_objects));
+            }
+            // No preconditions.
+            // Loads the permanent properties of the objects that aren't cached yet with a single batched read.
+            [[nodiscard]] UnitResultCode load_permanent_properties(const std::vector<ObjectS> &objects) {
+                using Result = UnitResultCode;
+
+                std::vector<std::pair<ObjectReferenceS, std::string>> uncached{};
+                std::vector<ObjectS> owners{};
+                for (const auto &object: objects) {
+                    for (auto &name: object->get_uncached_property_names(object->get_permanent_property_names())) {
+                        uncached.emplace_back(object->get_reference(), std::move(name));
+                        owners.push_back(object);
+                    }
+                }
+                if (uncached.empty())
+                    return Result::Ok();
+
+                UNWRAP_OR_RETURN(properties, PropertyFactory::LoadOrCreateMany(_call_context, std::move(uncached)));
+                for (size_t i = 0; i < properties.size(); ++i)
+                    owners[i]->cache_property(std::move(properties[i]));
+                return Result::Ok();
+            }
             [[nodiscard]]  ResultCode<std::optional<ObjectS>> maybe_resolve(ObjectHandleS handle) {
                 using Result = ResultCode<std::optional<ObjectS>>;
 
@@ -1250,67 +1468,78 @@ namespace estate {
                 fbs::Builder &target_builder, const data::ObjectReferenceS &start, WorkingSetS working_set) {
             using Result = ResultCode<fbs::Offset<fbs::Vector<fbs::Offset<NestedDataProto>>>>;
             std::unordered_set<data::ObjectReferenceWrapper, data::ObjectReferenceWrapper::Hasher> found{};
-            std::queue<data::ObjectReferenceS> to_write{};
-
-            to_write.push(start);
+            // Breadth-first, a level at a time, so each level's instances, indexes and properties are read in one batch each.
+            std::vector<data::ObjectReferenceS> to_write{start};
 
             std::vector<fbs::Offset<NestedDataProto>> data_protos{};
             while (!to_write.empty()) {
-                auto ref = to_write.front();
-                to_write.pop();
-
-                UNWRAP_OR_RETURN(maybe_object, working_set->maybe_resolve(ref, false));
-                if (!maybe_object) {
-                    if (*ref == *start) {
-                        //if the start object is missing, then return object not found.
-                        return Result::Error(Code::Datastore_ObjectNotFound);
+                UNWRAP_OR_RETURN(maybe_objects, working_set->maybe_resolve_many(to_write));
+
+                std::vector<ObjectS> objects{};
+                objects.reserve(to_write.size());
+                for (size_t i = 0; i < to_write.size(); ++i) {
+                    const auto &ref = to_write[i];
+                    auto &maybe_object = maybe_objects[i];
+                    if (!maybe_object) {
+                        if (*ref == *start) {
+                            //if the start object is missing, then return object not found.
+                            return Result::Error(Code::Datastore_ObjectNotFound);
+                        }
+                        //ignore all the other missing objects
+                        continue;
                     }
-                    //ignore all the other missing objects
-                    continue;
-                }
-                auto object = std::move(maybe_object.value());
+                    auto object = std::move(maybe_object.value());
 
-                if (object->is_permanent_deleted()) {
-                    if (*ref == *start) {
-                        //if the start object is deleted, then return object deleted.
-                        return Result::Error(Code::Datastore_ObjectDeleted);
+                    if (object->is_permanent_deleted()) {
+                        if (*ref == *start) {
+                            //if the start object is deleted, then return object deleted.
+                            return Result::Error(Code::Datastore_ObjectDeleted);
+                        }
+                        continue; //just leave the dangling reference so the client can issue a warning that the target object no longer exists.
                     }
-                    continue; //just leave the dangling reference so the client can issue a warning that the target object no longer exists.
+                    objects.push_back(std::move(object));
                 }
 
-                std::vector<fbs::Offset<NestedPropertyProto>> properties{};
+                WORKED_OR_RETURN(working_set->load_permanent_properties(objects));
 
-                for (const auto &property_name: object->get_permanent_property_names()) {
-                    UNWRAP_OR_RETURN(property, object->get_property(property_name));
-                    if (!property->saved_exists())
-                        continue;
+                std::vector<data::ObjectReferenceS> next{};
+                for (const auto &object: objects) {
+                    std::vector<fbs::Offset<NestedPropertyProto>> properties{};
+
+                    for (const auto &property_name: object->get_permanent_property_names()) {
+                        UNWRAP_OR_RETURN(property, object->get_property(property_name));
+                        if (!property->saved_exists())
+                            continue;
 
-                    const auto cell = property->get_saved_cell();
+                        const auto cell = property->get_saved_cell();
 
-                    auto name_off = target_builder.CreateString(property_name);
-                    const auto value = cell->value_bytes_nested_root();
+                        auto name_off = target_builder.CreateString(property_name);
+                        const auto value = cell->value_bytes_nested_root();
 
-                    //Save the reference for later resolution if it hasn't already been found.
-                    if (value->value_type() == ValueUnionProto::DataReferenceValueProto) {
-                        const auto ref_value = value->value_as_DataReferenceValueProto();
-                        const auto prop_ref = make_object_reference(data::ObjectType::WORKER_OBJECT, ref_value->class_id(),
-                                                                    PrimaryKey{ref_value->primary_key()->str()});
-                        ObjectReferenceWrapper ref_wrapper{prop_ref};
-                        if (!found.contains(ref_wrapper)) {
-                            to_write.push(std::move(prop_ref));
-                            found.insert(std::move(ref_wrapper));
+                        //Save the reference for later resolution if it hasn't already been found.
+                        if (value->value_type() == ValueUnionProto::DataReferenceValueProto) {
+                            const auto ref_value = value->value_as_DataReferenceValueProto();
+                            const auto prop_ref = make_object_reference(data::ObjectType::WORKER_OBJECT, ref_value->class_id(),
+                                                                        PrimaryKey{ref_value->primary_key()->str()});
+                            ObjectReferenceWrapper ref_wrapper{prop_ref};
+                            if (!found.contains(ref_wrapper)) {
+                                next.push_back(std::move(prop_ref));
+                                found.insert(std::move(ref_wrapper));
+                            }
                         }
+
+                        //Copy the value directly (does a memcpy internally)
+                        const auto value_bytes = cell->value_bytes();
+                        auto value_vec_off = target_builder.CreateVector(value_bytes->data(), value_bytes->size());
+                        properties.push_back(CreateNestedPropertyProto(target_builder, name_off, value_vec_off));
                     }
 
-                    //Copy the value directly (does a memcpy internally)
-                    const auto value_bytes = cell->value_bytes();
-                    auto value_vec_off = target_builder.CreateVector(value_bytes->data(), value_bytes->size());
-                    properties.push_back(CreateNestedPropertyProto(target_builder, name_off, value_vec_off));
+                    const auto ref = object->get_reference();
+                    const auto primary_key_off = target_builder.CreateString(ref->get_primary_key().view());
+                    data_protos.push_back(CreateNestedDataProto(target_builder, ref->class_id, object->get_version(), primary_key_off,
+                                                                             false, target_builder.CreateVector(properties)));
                 }
-
-                const auto primary_key_off = target_builder.CreateString(ref->get_primary_key().view());
-                data_protos.push_back(CreateNestedDataProto(target_builder, ref->class_id, object->get_version(), primary_key_off,
-                                                                         false, target_builder.CreateVector(properties)));
+                to_write = std::move(next);
             }
 
             return Result::Ok(target_builder.CreateVector(data_protos));
@@ -1409,6 +1638,20 @@ namespace estate {
                 ASSIGN_OR_RETURN(object, working_set->resolve(make_object_handle(ref, object_version, object_version)));
             }
 
+            // Read every touched property's cell in one batch
+            {
+                std::set<std::string> property_names{};
+                if (delta.properties()) {
+                    for (auto i = 0; i < delta.properties()->size(); ++i)
+                        property_names.emplace(delta.properties()->Get(i)->name()->str());
+                }
+                if (delta.deleted_properties()) {
+                    for (auto i = 0; i < delta.deleted_properties()->size(); ++i)
+                        property_names.emplace(delta.deleted_properties()->Get(i)->str());
+                }
+                WORKED_OR_RETURN(object->load_properties(property_names));
+            }
+
             // Create or Update properties
             if (delta.properties() && delta.properties()->size() > 0) {
                 for (auto i = 0; i < delta.properties()->size(); ++i) {
@@ -1416,18 +1659,19 @@ namespace estate {
 
                     auto property_name = updated_property->name()->str();
 
-                    UNWRAP_OR_RETURN(property, object->get_property(updated_property->name()->str()));
+                    UNWRAP_OR_RETURN(property, object->get_property(updated_property->name()->string_view()));
 
                     const auto *value_bytes = updated_property->value_bytes();
                     const auto value_checksum = data::get_crc(updated_property->value_bytes_nested_root());
 
                     //new or updated
-                    if (!property->saved_exists() || property->get_saved_cell()->checksum() != value_checksum) {
+                    if (!property->saved_exists() || get_cell_checksum(property->get_saved_cell()) != value_checksum) {
                         reusable_builder.Clear();
                         auto updated_cell = finish_and_copy_to_buffer(reusable_builder, buffer_pool,
                                                                       CreateCellProto(reusable_builder, value_checksum,
                                                                                       reusable_builder.CreateVector(value_bytes->data(),
-                                                                                                                    value_bytes->size())));
+                                                                                                                    value_bytes->size()),
+                                                                                      ESTATE_CELL_CHECKSUM_VERSION));
                         property->set_cell(std::move(updated_cell));
                         assert(property->exists());
                         any_changes = true;
@@ -1438,7 +1682,7 @@ namespace estate {
             // Delete properties
             if (delta.deleted_properties() && delta.deleted_properties()->size() > 0) {
                 for (auto i = 0; i < delta.deleted_properties()->size(); ++i) {
-                    UNWRAP_OR_RETURN(property, object->get_property(delta.deleted_properties()->Get(i)->str()));
+                    UNWRAP_OR_RETURN(property, object->get_property(delta.deleted_properties()->Get(i)->string_view()));
                     if (object->erase_property(property, false))
                         any_changes = true;
                 }
@@ -1494,30 +1738,83 @@ namespace estate {
         class TransactionImpl : public virtual ITransaction {
             const WorkerId _worker_id;
             WorkerVersion _worker_version;
-            rocksdb::Transaction *_txn;
+            rocksdb::Transaction *_txn; //nullptr when read-only
+            const rocksdb::Snapshot *_snapshot; //only when read-only
+            rocksdb::OptimisticTransactionDB *_txn_db;
+            rocksdb::DB *_base_db;
             rocksdb::ColumnFamilyHandle *_default_column_family;
             BufferPoolS _buffer_pool;
             const LogContext &_log_context;
             friend class DatabaseImpl;
             static const rocksdb::ReadOptions READ_OPTIONS;
+            static const rocksdb::ReadOptions MULTI_GET_READ_OPTIONS;
             static const rocksdb::WriteOptions WRITE_OPTIONS;
+            rocksdb::ReadOptions _read_options{READ_OPTIONS};
+            rocksdb::ReadOptions _multi_get_read_options{MULTI_GET_READ_OPTIONS};
         public:
             TransactionImpl(const TransactionImpl &other) = delete;
             TransactionImpl(TransactionImpl &&other) = delete;
-            explicit TransactionImpl(const LogContext &log_context, rocksdb::Transaction *txn, rocksdb::ColumnFamilyHandle *default_column_family,
-                                     const WorkerId worker_id, const WorkerVersion worker_version, BufferPoolS buffer_pool) :
-                    _log_context(log_context), _txn(txn), _default_column_family(default_column_family), _worker_id(worker_id),
-                    _worker_version(worker_version), _buffer_pool(buffer_pool) {
+            explicit TransactionImpl(const LogContext &log_context, rocksdb::Transaction *txn, rocksdb::OptimisticTransactionDB *txn_db,
+                                     rocksdb::DB *base_db, const WorkerId worker_id, const WorkerVersion worker_version, BufferPoolS buffer_pool) :
+                    _log_context(log_context), _txn(txn), _snapshot(nullptr), _txn_db(txn_db), _base_db(base_db),
+                    _default_column_family(base_db->DefaultColumnFamily()),
+                    _worker_id(worker_id), _worker_version(worker_version), _buffer_pool(buffer_pool) {
+            }
+            /* Read-only, reading straight from the database as of the snapshot. Nothing is tracked for conflict checking so it costs
+             * concurrent writers nothing to validate, and it's never committed. Takes ownership of the snapshot. */
+            explicit TransactionImpl(const LogContext &log_context, const rocksdb::Snapshot *snapshot, rocksdb::OptimisticTransactionDB *txn_db,
+                                     rocksdb::DB *base_db, const WorkerId worker_id, const WorkerVersion worker_version, BufferPoolS buffer_pool) :
+                    _log_context(log_context), _txn(nullptr), _snapshot(snapshot), _txn_db(txn_db), _base_db(base_db),
+                    _default_column_family(base_db->DefaultColumnFamily()),
+                    _worker_id(worker_id), _worker_version(worker_version), _buffer_pool(buffer_pool) {
+                assert(snapshot);
+                _read_options.snapshot = snapshot;
+                _multi_get_read_options.snapshot = snapshot;
             }
             ~TransactionImpl() override {
+                if (_snapshot)
+                    _base_db->ReleaseSnapshot(_snapshot);
                 delete _txn;
             }
         private:
             rocksdb::Status get_for_read(const rocksdb::Slice &key, std::string &buffer) {
-                return _txn->Get(READ_OPTIONS, _default_column_family, key, &buffer);
+                if (is_read_only())
+                    return _base_db->Get(_read_options, _default_column_family, key, &buffer);
+                return _txn->Get(_read_options, _default_column_family, key, &buffer);
             }
             rocksdb::Status get_for_update(const rocksdb::Slice &key, std::string &buffer) {
-                return _txn->GetForUpdate(READ_OPTIONS, _default_column_family, key, &buffer);
+                if (is_read_only())
+                    return get_for_read(key, buffer);
+                return _txn->GetForUpdate(_read_options, _default_column_family, key, &buffer);
+            }
+            std::vector<rocksdb::Status> multi_get_for_update(const std::vector<rocksdb::Slice> &keys, std::vector<std::string> &values) {
+                const std::vector<rocksdb::ColumnFamilyHandle *> column_families(keys.size(), _default_column_family);
+                if (is_read_only())
+                    return _base_db->MultiGet(_multi_get_read_options, column_families, keys, &values);
+                return _txn->MultiGetForUpdate(_multi_get_read_options, column_families, keys, &values);
+            }
+            rocksdb::Status put(const rocksdb::Slice &key, const rocksdb::Slice &value) {
+                if (is_read_only()) {
+                    assert(false);
+                    return rocksdb::Status::NotSupported("read-only transaction");
+                }
+                return _txn->Put(_default_column_family, key, value);
+            }
+            rocksdb::Status remove(const rocksdb::Slice &key) {
+                if (is_read_only()) {
+                    assert(false);
+                    return rocksdb::Status::NotSupported("read-only transaction");
+                }
+                return _txn->Delete(_default_column_family, key);
+            }
+            // Moves a value read by multi_get_for_update into a pooled buffer.
+            template<typename T>
+            Buffer<T> to_buffer(std::string &value) {
+                auto buffer = _buffer_pool->get_buffer<T>();
+                buffer.with_internal_buffer([&](estate::InternalBuffer &buff) {
+                    buff.swap(value);
+                });
+                return std::move(buffer);
             }
         public:
             UnitResultCode write_object_instance(const data::ObjectReferenceS &ref, ObjectVersion version, bool deleted) override {
@@ -1528,7 +1825,7 @@ namespace estate {
                 builder.Finish(CreateObjectInstanceProto(builder, version, deleted, (uint8_t) ref->type));
                 rocksdb::Slice vval{reinterpret_cast<const char *>(builder.GetBufferPointer()), builder.GetSize()};
 
-                const auto put_s = this->_txn->Put(_default_column_family, ref->get_object_instance_key(), vval);
+                const auto put_s = put(ref->get_object_instance_key(), vval);
                 if (!put_s.ok()) {
                     log_object_error_status(_log_context, _worker_id, ref->class_id, ref->get_primary_key(), put_s, "putting object instance");
                     return Result::Error(Code::Datastore_Unknown);
@@ -1557,7 +1854,7 @@ namespace estate {
                 }
 
                 rocksdb::Slice vval{reinterpret_cast<const char *>(builder.GetBufferPointer()), builder.GetSize()};
-                const auto put_s = this->_txn->Put(_default_column_family, ref->get_object_properties_index_key(), vval);
+                const auto put_s = put(ref->get_object_properties_index_key(), vval);
                 if (!put_s.ok()) {
                     log_object_error_status(_log_context, _worker_id, ref->class_id, ref->get_primary_key(), put_s, "putting object properties index");
                     return Result::Error(Code::Datastore_Unknown);
@@ -1628,9 +1925,107 @@ namespace estate {
                 return Result::Ok(std::move(object_properties_index));
             }
 
+            ResultCode<std::vector<std::optional<Buffer<ObjectInstanceProto>>>>
+            maybe_get_object_instances(const std::vector<data::ObjectReferenceS> &refs) override {
+                using Result = ResultCode<std::vector<std::optional<Buffer<ObjectInstanceProto>>>>;
+
+                std::vector<rocksdb::Slice> keys{};
+                keys.reserve(refs.size());
+                for (const auto &ref: refs)
+                    keys.emplace_back(ref->get_object_instance_key());
+                std::vector<std::string> values{};
+                const auto statuses = multi_get_for_update(keys, values);
+
+                std::vector<std::optional<Buffer<ObjectInstanceProto>>> object_instances{};
+                object_instances.reserve(refs.size());
+                for (size_t i = 0; i < refs.size(); ++i) {
+                    const auto &ref = refs[i];
+                    const auto &status = statuses[i];
+                    if (status.IsNotFound()) {
+                        object_instances.emplace_back(std::nullopt);
+                        continue;
+                    }
+                    if (!status.ok()) {
+                        log_object_error_status(_log_context, _worker_id, ref->class_id, ref->get_primary_key(), status, "getting object instances");
+                        return Result::Error(Code::Datastore_Unknown);
+                    }
+                    if (values[i].empty()) {
+                        log_error(_log_context, "{0} object instance corrupt", get_class_log_context(_worker_id, ref->class_id, ref->get_primary_key()));
+                        return Result::Error(Code::Datastore_ObjectInstanceCorrupted);
+                    }
+                    object_instances.emplace_back(to_buffer<ObjectInstanceProto>(values[i]));
+                }
+
+                return Result::Ok(std::move(object_instances));
+            }
+            ResultCode<std::vector<std::optional<Buffer<ObjectPropertiesIndexProto>>>>
+            maybe_get_object_properties_indexes(const std::vector<data::ObjectReferenceS> &refs) override {
+                using Result = ResultCode<std::vector<std::optional<Buffer<ObjectPropertiesIndexProto>>>>;
+
+                std::vector<rocksdb::Slice> keys{};
+                keys.reserve(refs.size());
+                for (const auto &ref: refs)
+                    keys.emplace_back(ref->get_object_properties_index_key());
+                std::vector<std::string> values{};
+                const auto statuses = multi_get_for_update(keys, values);
+
+                std::vector<std::optional<Buffer<ObjectPropertiesIndexProto>>> object_properties_indexes{};
+                object_properties_indexes.reserve(refs.size());
+                for (size_t i = 0; i < refs.size(); ++i) {
+                    const auto &ref = refs[i];
+                    const auto &status = statuses[i];
+                    if (status.IsNotFound()) {
+                        object_properties_indexes.emplace_back(std::nullopt);
+                        continue;
+                    }
+                    if (!status.ok()) {
+                        log_object_error_status(_log_context, _worker_id, ref->class_id, ref->get_primary_key(), status, "getting object properties indexes");
+                        return Result::Error(Code::Datastore_Unknown);
+                    }
+                    if (values[i].empty()) {
+                        log_error(_log_context, "{0} object properties index corrupt",
+                                  get_class_log_context(_worker_id, ref->class_id, ref->get_primary_key()));
+                        return Result::Error(Code::Datastore_ObjectPropertiesIndexCorrupted);
+                    }
+                    object_properties_indexes.emplace_back(to_buffer<ObjectPropertiesIndexProto>(values[i]));
+                }
+
+                return Result::Ok(std::move(object_properties_indexes));
+            }
             void undo_get_for_update(const std::string_view key) override {
+                if (is_read_only())
+                    return; //nothing was tracked
                 _txn->UndoGetForUpdate(_default_column_family, key);
             }
+            bool is_read_only() const override {
+                return _txn == nullptr;
+            }
+            ResultCode<std::vector<std::optional<data::Cell>>> maybe_get_cells(const std::vector<std::string> &property_keys) override {
+                using Result = ResultCode<std::vector<std::optional<data::Cell>>>;
+
+                const std::vector<rocksdb::Slice> keys{property_keys.begin(), property_keys.end()};
+                std::vector<std::string> values{};
+                const auto statuses = multi_get_for_update(keys, values);
+
+                std::vector<std::optional<data::Cell>> cells{};
+                cells.reserve(keys.size());
+                for (size_t i = 0; i < keys.size(); ++i) {
+                    const auto &get_s = statuses[i];
+                    if (get_s.IsNotFound()) {
+                        cells.emplace_back(std::nullopt);
+                        continue;
+                    }
+                    if (!get_s.ok()) {
+                        log_error(_log_context,
+                                  "worker id: {} property key: {} rocks db status: {} Failuring while getting cells",
+                                  _worker_id, property_keys[i], get_s.ToString());
+                        return Result::Error(Code::Datastore_Unknown);
+                    }
+                    cells.emplace_back(to_buffer<CellProto>(values[i]));
+                }
+
+                return Result::Ok(std::move(cells));
+            }
             ResultCode<std::optional<data::Cell>> maybe_get_cell(const std::string &property_key) override {
                 using Result = ResultCode<std::optional<data::Cell>>;
 
@@ -1658,7 +2053,7 @@ namespace estate {
                 using Result = UnitResultCode;
 
                 rocksdb::Slice cell_slice{cell_buffer.as_char(), cell_buffer.size()};
-                auto put_s = _txn->Put(_default_column_family, key, cell_slice);
+                auto put_s = put(key, cell_slice);
                 if (!put_s.ok()) {
                     log_error(_log_context,
                               "worker id: {} property key: {} rocks db status: {} Failuring while writing cell",
@@ -1670,7 +2065,7 @@ namespace estate {
             }
             virtual UnitResultCode delete_value(const std::string_view key) override {
                 using Result = UnitResultCode;
-                auto delete_s = _txn->Delete(_default_column_family, key);
+                auto delete_s = remove(key);
                 if (!delete_s.ok()) {
                     log_error(_log_context,
                               "worker id: {} property key: {} rocks db status: {} Failuring while deleting property",
@@ -1688,7 +2083,7 @@ namespace estate {
             UnitResultCode delete_worker_index() override {
                 using Result = UnitResultCode;
 
-                auto delete_s = _txn->Delete(ESTATE_DB_WORKER_INDEX_KEY);
+                auto delete_s = remove(ESTATE_DB_WORKER_INDEX_KEY);
                 if (!delete_s.ok()) {
                     log_worker_version_error_status(_log_context, _worker_id, _worker_version, delete_s, "deleting worker index");
                     return Result::Error(Code::Datastore_Unknown);
@@ -1698,24 +2093,34 @@ namespace estate {
             UnitResultCode delete_engine_source() override {
                 using Result = UnitResultCode;
 
-                auto delete_s = _txn->Delete(ESTATE_DB_ENGINE_SOURCE_KEY);
+                auto delete_s = remove(ESTATE_DB_ENGINE_SOURCE_KEY);
                 if (!delete_s.ok()) {
                     log_worker_version_error_status(_log_context, _worker_id, _worker_version, delete_s, "deleting engine data");
                     return Result::Error(Code::Datastore_Unknown);
                 }
                 return Result::Ok();
             }
+            UnitResultCode delete_engine_snapshot() override {
+                using Result = UnitResultCode;
+
+                auto delete_s = remove(ESTATE_DB_ENGINE_SNAPSHOT_KEY);
+                if (!delete_s.ok()) {
+                    log_worker_version_error_status(_log_context, _worker_id, _worker_version, delete_s, "deleting engine snapshot");
+                    return Result::Error(Code::Datastore_Unknown);
+                }
+                return Result::Ok();
+            }
             UnitResultCode save_worker_index(const WorkerVersion new_worker_version, const BufferView<WorkerIndexProto> &worker_index) override {
                 using Result = UnitResultCode;
 
                 auto worker_version_str = std::to_string(new_worker_version);
-                auto put_worker_version_s = _txn->Put(ESTATE_DB_WORKER_VERSION_KEY, worker_version_str);
+                auto put_worker_version_s = put(ESTATE_DB_WORKER_VERSION_KEY, worker_version_str);
                 if (!put_worker_version_s.ok()) {
                     log_worker_version_error_status(_log_context, _worker_id, _worker_version, put_worker_version_s, "putting worker version");
                 }
 
                 rocksdb::Slice slice(worker_index.as_char(), worker_index.size());
-                auto put_index_s = _txn->Put(ESTATE_DB_WORKER_INDEX_KEY, slice);
+                auto put_index_s = put(ESTATE_DB_WORKER_INDEX_KEY, slice);
                 if (!put_index_s.ok()) {
                     log_worker_version_error_status(_log_context, _worker_id, _worker_version, put_index_s, "putting worker index");
                     return Result::Error(Code::Datastore_Unknown);
@@ -1728,6 +2133,12 @@ namespace estate {
             UnitResultCode commit() override {
                 using Result = UnitResultCode;
 
+                if (is_read_only()) {
+                    assert(false);
+                    log_error(_log_context, "{0} attempted to commit a read-only transaction", get_worker_version_log_context(_worker_id, _worker_version));
+                    return Result::Error(Code::Datastore_Unknown);
+                }
+
                 auto commit_s = _txn->Commit();
                 if (!commit_s.ok()) {
                     if (commit_s.IsBusy())
@@ -1761,7 +2172,7 @@ namespace estate {
                 using Result = UnitResultCode;
 
                 rocksdb::Slice slice(engine_source.as_char(), engine_source.size());
-                auto put_s = _txn->Put(ESTATE_DB_ENGINE_SOURCE_KEY, slice);
+                auto put_s = put(ESTATE_DB_ENGINE_SOURCE_KEY, slice);
                 if (!put_s.ok()) {
                     log_worker_version_error_status(_log_context, _worker_id, _worker_version, put_s, "putting engine source");
                     return Result::Error(Code::Datastore_Unknown);
@@ -1787,17 +2198,126 @@ namespace estate {
 
                 return Result::Ok(std::move(engine_source));
             }
+            UnitResultCode save_engine_snapshot(std::string_view engine_snapshot) override {
+                using Result = UnitResultCode;
+
+                rocksdb::Slice slice(engine_snapshot.data(), engine_snapshot.size());
+                auto put_s = put(ESTATE_DB_ENGINE_SNAPSHOT_KEY, slice);
+                if (!put_s.ok()) {
+                    log_worker_version_error_status(_log_context, _worker_id, _worker_version, put_s, "putting engine snapshot");
+                    return Result::Error(Code::Datastore_Unknown);
+                }
+                return Result::Ok();
+            }
+            ResultCode<std::optional<Buffer<u8>>> maybe_get_engine_snapshot() override {
+                using Result = ResultCode<std::optional<Buffer<u8>>>;
+
+                auto engine_snapshot = _buffer_pool->get_buffer<u8>();
+                const auto status = engine_snapshot.with_internal_buffer<Status>([this](InternalBuffer &buffer) {
+                    return get_for_read(ESTATE_DB_ENGINE_SNAPSHOT_KEY, buffer);
+                });
+
+                if (status.IsNotFound()) {
+                    return Result::Ok(std::nullopt);
+                }
+                if (!status.ok()) {
+                    log_worker_version_error_status(_log_context, _worker_id, _worker_version, status, "getting engine snapshot");
+                    return Result::Error(Code::Datastore_Unknown);
+                }
+
+                return Result::Ok(std::move(engine_snapshot));
+            }
+            UnitResultCode delete_code_cache(u16 file_name_id) override {
+                using Result = UnitResultCode;
+
+                auto delete_s = remove(create_code_cache_key(_worker_version, file_name_id));
+                if (!delete_s.ok()) {
+                    log_worker_version_error_status(_log_context, _worker_id, _worker_version, delete_s, "deleting code cache");
+                    return Result::Error(Code::Datastore_Unknown);
+                }
+                return Result::Ok();
+            }
+            UnitResultCode save_code_cache(u16 file_name_id, std::string_view code_cache) override {
+                using Result = UnitResultCode;
+
+                rocksdb::Slice slice(code_cache.data(), code_cache.size());
+                auto put_s = put(create_code_cache_key(_worker_version, file_name_id), slice);
+                if (!put_s.ok()) {
+                    log_worker_version_error_status(_log_context, _worker_id, _worker_version, put_s, "putting code cache");
+                    return Result::Error(Code::Datastore_Unknown);
+                }
+                return Result::Ok();
+            }
+            UnitResultCode refresh_code_cache(u16 file_name_id, std::string_view code_cache) override {
+                using Result = UnitResultCode;
+
+                /* Setting up a new version and deleting the worker write these keys, so reading them for update makes a refresh that
+                 * raced either one fail to commit. */
+                std::unique_ptr<rocksdb::Transaction> refresh_txn{_txn_db->BeginTransaction(WRITE_OPTIONS)};
+                std::string value{};
+                auto get_s = refresh_txn->GetForUpdate(READ_OPTIONS, ESTATE_DB_WORKER_VERSION_KEY, &value);
+                if (!get_s.ok() || value.empty() || std::stoull(value) != _worker_version) {
+                    log_trace(_log_context, "Not refreshing code cache {} because the worker is no longer at version {}", file_name_id,
+                              _worker_version);
+                    return Result::Error(Code::Datastore_MustGetLatestWorker);
+                }
+                value.clear();
+                get_s = refresh_txn->GetForUpdate(READ_OPTIONS, ESTATE_DB_DELETED_KEY, &value);
+                if (get_s.ok() && value == "true") {
+                    log_trace(_log_context, "Not refreshing code cache {} because the worker was deleted", file_name_id);
+                    return Result::Error(Code::Datastore_DeletedFlagExists);
+                }
+
+                rocksdb::Slice slice(code_cache.data(), code_cache.size());
+                auto put_s = refresh_txn->Put(create_code_cache_key(_worker_version, file_name_id), slice);
+                if (put_s.ok())
+                    put_s = refresh_txn->Commit();
+                if (put_s.IsBusy() || put_s.IsTryAgain()) {
+                    log_trace(_log_context, "Not refreshing code cache {} because the worker changed while it was written", file_name_id);
+                    return Result::Error(Code::Datastore_WriteConflictTryAgain);
+                }
+                if (!put_s.ok()) {
+                    log_worker_version_error_status(_log_context, _worker_id, _worker_version, put_s, "refreshing code cache");
+                    return Result::Error(Code::Datastore_Unknown);
+                }
+                return Result::Ok();
+            }
+            ResultCode<std::optional<Buffer<u8>>> maybe_get_code_cache(u16 file_name_id) override {
+                using Result = ResultCode<std::optional<Buffer<u8>>>;
+
+                auto code_cache = _buffer_pool->get_buffer<u8>();
+                const auto status = code_cache.with_internal_buffer<Status>([this, file_name_id](InternalBuffer &buffer) {
+                    return get_for_read(create_code_cache_key(_worker_version, file_name_id), buffer);
+                });
+
+                if (status.IsNotFound() || (status.ok() && code_cache.empty())) {
+                    return Result::Ok(std::nullopt);
+                }
+                if (!status.ok()) {
+                    log_worker_version_error_status(_log_context, _worker_id, _worker_version, status, "getting code cache");
+                    return Result::Error(Code::Datastore_Unknown);
+                }
+
+                return Result::Ok(std::move(code_cache));
+            }
         };
 
         const rocksdb::WriteOptions TransactionImpl::WRITE_OPTIONS{}; // NOLINT(cert-err58-cpp)
         const rocksdb::ReadOptions TransactionImpl::READ_OPTIONS{}; // NOLINT(cert-err58-cpp)
+        const rocksdb::ReadOptions TransactionImpl::MULTI_GET_READ_OPTIONS = []() { // NOLINT(cert-err58-cpp)
+            rocksdb::ReadOptions options{};
+#if ROCKSDB_MAJOR >= 7
+            options.async_io = true; //lets MultiGet read the batch's data blocks in parallel
+#endif
+            return options;
+        }();
 
         ResultCode<bool, Code> is_deleted(const LogContext &log_context, rocksdb::DB *db, const WorkerId &worker_id) {
             assert(db);
             using Result = ResultCode<bool, Code>;
 
             std::string buffer{};
-            auto s = db->Get(rocksdb::ReadOptions(), "deleted", &buffer);
+            auto s = db->Get(rocksdb::ReadOptions(), ESTATE_DB_DELETED_KEY, &buffer);
             if (!s.ok()) {
                 if (s.IsNotFound())
                     return Result::Ok(false);
@@ -1872,9 +2392,30 @@ namespace estate {
                 if (worker_version_comp != worker_version)
                     return Result::Error(Code::Datastore_MustGetLatestWorker);
 
-                return Result::Ok(std::make_shared<TransactionImpl>(log_context, inner_txn, base_db->DefaultColumnFamily(), worker_id, worker_version,
+                return Result::Ok(std::make_shared<TransactionImpl>(log_context, inner_txn, txn_db, base_db, worker_id, worker_version,
                                                                     buffer_pool));
             }
+            ResultCode<ITransactionS, Code> create_read_only_transaction(const LogContext &log_context, WorkerVersion worker_version) override {
+                using Result = ResultCode<ITransactionS, Code>;
+
+                auto txn = std::make_shared<TransactionImpl>(log_context, base_db->GetSnapshot(), txn_db, base_db, worker_id, worker_version,
+                                                             buffer_pool);
+
+                std::string worker_version_str;
+                auto s = base_db->Get(txn->_read_options, ESTATE_DB_WORKER_VERSION_KEY, &worker_version_str);
+                if (!s.ok()) {
+                    log_worker_error_status(log_context, worker_id, s, "getting latest worker version number");
+                    return Result::Error(Code::Datastore_Unknown);
+                }
+                if (worker_version_str.empty()) {
+                    log_error(log_context, "{} {} was empty", get_worker_log_context(worker_id), ESTATE_DB_WORKER_VERSION_KEY);
+                    return Result::Error(Code::Datastore_WorkerVersionCorrupted);
+                }
+                if (std::stoull(worker_version_str) != worker_version)
+                    return Result::Error(Code::Datastore_MustGetLatestWorker);
+
+                return Result::Ok(std::move(txn));
+            }
             ResultCode<Buffer<WorkerIndexProto>, Code> get_worker_index(const LogContext &log_context) override {
                 using Result = ResultCode<Buffer<WorkerIndexProto>, Code>;
 
@@ -1922,7 +2463,7 @@ namespace estate {
             UnitResultCode mark_as_deleted(const LogContext &log_context) override {
                 using Result = UnitResultCode;
 
-                auto s = base_db->Put(WRITE_OPTIONS, "deleted", "true");
+                auto s = base_db->Put(WRITE_OPTIONS, ESTATE_DB_DELETED_KEY, "true");
                 if (!s.ok()) {
                     log_worker_error_status(log_context, worker_id, s, "marking as deleted");
                     return Result::Error(Code::Datastore_Unknown);
@@ -1936,6 +2477,29 @@ namespace estate {
 
                 return Result::Ok();
             }
+            ResultCode<u32, Code> get_warm_engine_count(const LogContext &log_context) override {
+                using Result = ResultCode<u32, Code>;
+
+                std::string warm_engine_count_str;
+                auto s = base_db->Get(READ_OPTIONS, ESTATE_DB_WARM_ENGINE_COUNT_KEY, &warm_engine_count_str);
+                if (s.IsNotFound() || (s.ok() && warm_engine_count_str.empty()))
+                    return Result::Ok(0);
+                if (!s.ok()) {
+                    log_worker_error_status(log_context, worker_id, s, "getting warm engine count");
+                    return Result::Error(Code::Datastore_Unknown);
+                }
+                return Result::Ok(static_cast<u32>(std::stoul(warm_engine_count_str)));
+            }
+            UnitResultCode save_warm_engine_count(const LogContext &log_context, u32 warm_engine_count) override {
+                using Result = UnitResultCode;
+
+                auto s = base_db->Put(WRITE_OPTIONS, ESTATE_DB_WARM_ENGINE_COUNT_KEY, std::to_string(warm_engine_count));
+                if (!s.ok()) {
+                    log_worker_error_status(log_context, worker_id, s, "putting warm engine count");
+                    return Result::Error(Code::Datastore_Unknown);
+                }
+                return Result::Ok();
+            }
         };
 
         const rocksdb::ReadOptions DatabaseImpl::READ_OPTIONS{};
@@ -2118,7 +2682,7 @@ namespace estate {
         }
         fbs::BuilderS CallContext::get_reusable_builder(bool clear) {
             if (!_maybe_reusable_builder.has_value())
-                _maybe_reusable_builder.emplace(std::make_shared<flatbuffers::FlatBufferBuilder>());
+                _maybe_reusable_builder.emplace(std::make_shared<PooledBuilder>(_buffer_pool));
 
             if (clear)
                 _maybe_reusable_builder.value()->Clear();
@@ -2191,8 +2755,30 @@ namespace estate {
             struct ObjectFactoryFunctions {
                 std::map<ClassId, v8::Global<v8::Function>> graft_functions;
                 std::map<ClassId, v8::Global<v8::Function>> new_functions;
+                std::map<ClassId, v8::Global<v8::Object>> prototypes;
             };
             using ObjectFactoryFunctionsU = std::unique_ptr<ObjectFactoryFunctions>;
+            struct ServiceMethod {
+                std::string_view method_name{}; //into the engine's worker index, empty when the method id isn't indexed
+                v8::Global<v8::Function> function{};
+                Code error{Code::ScriptEngine_MethodNotFound}; //why function is empty
+            };
+            /* Service methods indexed by class id then method id. Ids are assigned densely by the indexer so dispatch is two
+             * vector lookups instead of a scan of the worker index and a property lookup on the prototype chain. */
+            using ServiceMethodTable = std::vector<std::optional<std::vector<ServiceMethod>>>;
+            // A method, getter, and/or setter declared on a Data or Service class, resolved off the class prototype.
+            struct ClassMember {
+                int hash; //of name
+                v8::Global<v8::String> name{}; //internalized
+                bool is_method{false};
+                bool is_getter{false};
+                bool is_setter{false};
+                v8::Global<v8::Function> method{}; //these are empty when they couldn't be resolved
+                v8::Global<v8::Function> getter{};
+                v8::Global<v8::Function> setter{};
+            };
+            // Indexed by class id so the property interceptors don't hash or allocate the property name.
+            using ClassMemberTable = std::vector<std::vector<ClassMember>>;
             class Engine {
                 std::optional<Code> _internal_error;
                 WorkerVersion _worker_version;
@@ -2204,9 +2790,15 @@ namespace estate {
                 std::optional<std::map<ClassId, std::pair<std::string_view, data::ClassType>>> _maybe_class_name_types{};
                 std::optional<std::map<std::string_view, ClassId>> _maybe_class_ids{};
                 std::optional<std::set<std::string>> _maybe_passthrough_class_name_holder{};
-                std::map<ClassId, std::optional<std::set<std::string>>> _service_method_sets{};
-                std::map<ClassId, std::optional<std::multimap<std::string, MethodKindProto>>> _object_method_maps{};
                 ObjectFactoryFunctionsU _object_factory_functions;
+                ServiceMethodTable _service_methods{};
+                ClassMemberTable _class_members{};
+                v8::Global<v8::String> _primary_key_name{};
+                // When the isolate was deserialized from a snapshot the blob must outlive it.
+                std::optional<Buffer<u8>> _snapshot{};
+                std::unique_ptr<v8::StartupData> _startup_data{};
+                // Set when a call was terminated by the watchdog, the isolate may be left in any state so it isn't reused.
+                bool _terminated{false};
                 bool _moved{false};
             public:
                 Engine(Buffer<WorkerIndexProto> worker_index,
@@ -2221,6 +2813,8 @@ namespace estate {
                         _object_factory_functions{std::move(object_factory_functions)} {
                     parent_context->SetEmbedderData(0, v8::External::New(isolate, this));
                     _parent_context.Reset(_isolate, parent_context);
+                    build_service_method_table(parent_context);
+                    build_class_member_table(parent_context); //reuses the service method table
                 }
                 Engine(const Engine &other) = delete;
                 Engine(Engine &&other) noexcept:
@@ -2231,13 +2825,20 @@ namespace estate {
                         _call_context(std::move(other._call_context)),
                         _worker_index(std::move(other._worker_index)),
                         _internal_error(std::move(other._internal_error)),
-                        _service_method_sets(std::move(other._service_method_sets)),
-                        _object_method_maps(std::move(other._object_method_maps)),
+                        _object_factory_functions(std::move(other._object_factory_functions)),
+                        _service_methods(std::move(other._service_methods)),
+                        _class_members(std::move(other._class_members)),
+                        _primary_key_name(std::move(other._primary_key_name)),
+                        _snapshot(std::move(other._snapshot)),
+                        _startup_data(std::move(other._startup_data)),
                         _moved(false) {
                     other._moved = true;
                 }
                 ~Engine() {
                     if (!_moved) {
+                        _service_methods.clear();
+                        _class_members.clear();
+                        _primary_key_name.Reset();
                         _object_factory_functions.release();
                         _parent_context.Reset();
                         _isolate->Dispose();
@@ -2245,6 +2846,142 @@ namespace estate {
                         delete _allocator;
                     }
                 }
+            private:
+                // Resolves every indexed service method off its class prototype once, when the engine is created.
+                void build_service_method_table(v8::Local<v8::Context> context) {
+                    const auto *service_classes = _worker_index->service_classes();
+                    if (!service_classes)
+                        return;
+                    auto isolate = _isolate;
+                    v8::HandleScope handle_scope(isolate);
+                    for (auto i = 0; i < service_classes->size(); ++i) {
+                        const auto cls = service_classes->Get(i);
+                        const auto class_id = cls->class_id();
+                        if (_service_methods.size() <= class_id)
+                            _service_methods.resize(class_id + 1);
+                        auto &methods = _service_methods[class_id].emplace();
+                        if (!cls->methods())
+                            continue;
+
+                        const auto proto_it = _object_factory_functions->prototypes.find(class_id);
+                        v8::Local<v8::Object> prototype{};
+                        if (proto_it != _object_factory_functions->prototypes.cend())
+                            prototype = proto_it->second.Get(_isolate);
+
+                        for (auto j = 0; j < cls->methods()->size(); ++j) {
+                            const auto method = cls->methods()->Get(j);
+                            const auto method_id = method->method_id();
+                            if (methods.size() <= method_id)
+                                methods.resize(method_id + 1);
+                            auto &entry = methods[method_id];
+                            entry.method_name = method->method_name()->string_view();
+
+                            v8::Local<v8::Value> method_val;
+                            if (prototype.IsEmpty() ||
+                                !prototype->Get(context, V8_STRING(entry.method_name.data(), entry.method_name.size())).ToLocal(&method_val)) {
+                                entry.error = Code::ScriptEngine_UnableToGetMethod;
+                            } else if (!method_val->IsFunction()) {
+                                entry.error = Code::ScriptEngine_UnableToGetMethodBecauseItWasNotAFunction;
+                            } else {
+                                entry.function.Reset(_isolate, v8::Local<v8::Function>::Cast(method_val));
+                            }
+                        }
+                    }
+                }
+                static v8::Local<v8::String> InternalizeName(v8::Isolate *isolate, std::string_view name) {
+                    return v8::String::NewFromUtf8(isolate, name.data(), v8::NewStringType::kInternalized,
+                                                   static_cast<int>(name.size())).ToLocalChecked();
+                }
+                ClassMember &add_class_member(ClassId class_id, std::string_view name) {
+                    if (_class_members.size() <= class_id)
+                        _class_members.resize(class_id + 1);
+                    auto &members = _class_members[class_id];
+                    auto internalized = InternalizeName(_isolate, name);
+                    for (auto &member: members) {
+                        if (member.name == internalized)
+                            return member;
+                    }
+                    auto &member = members.emplace_back(ClassMember{internalized->GetIdentityHash()});
+                    member.name.Reset(_isolate, internalized);
+                    return member;
+                }
+                // Resolves the methods, getters, and setters of every indexed class off its prototype once.
+                void build_class_member_table(v8::Local<v8::Context> context) {
+                    auto isolate = _isolate;
+                    v8::HandleScope handle_scope(isolate);
+                    _primary_key_name.Reset(isolate, InternalizeName(isolate, "primaryKey"));
+
+                    static const std::string GET{"get"};
+                    static const std::string SET{"set"};
+                    const auto get_str = InternalizeName(isolate, GET);
+                    const auto set_str = InternalizeName(isolate, SET);
+                    const auto get_accessor = [&](v8::Local<v8::Object> prototype, v8::Local<v8::String> name,
+                                                  v8::Local<v8::String> kind) -> v8::Local<v8::Function> {
+                        v8::Local<v8::Value> descriptor, accessor;
+                        if (prototype.IsEmpty() ||
+                            !prototype->GetOwnPropertyDescriptor(context, name).ToLocal(&descriptor) || !descriptor->IsObject() ||
+                            !descriptor.As<v8::Object>()->Get(context, kind).ToLocal(&accessor) || !accessor->IsFunction())
+                            return {};
+                        return accessor.As<v8::Function>();
+                    };
+
+                    // Service classes only declare methods, which build_service_method_table already resolved
+                    for (size_t class_id = 0; class_id < _service_methods.size(); ++class_id) {
+                        if (!_service_methods[class_id].has_value())
+                            continue;
+                        for (const auto &service_method: _service_methods[class_id].value()) {
+                            if (service_method.method_name.empty())
+                                continue;
+                            auto &member = add_class_member(static_cast<ClassId>(class_id), service_method.method_name);
+                            member.is_method = true;
+                            if (!service_method.function.IsEmpty())
+                                member.method.Reset(isolate, service_method.function.Get(isolate));
+                        }
+                    }
+                    const auto &worker_index = get_worker_index();
+                    if (worker_index.data_classes()) {
+                        for (auto c = 0; c < worker_index.data_classes()->size(); ++c) {
+                            const auto cls = worker_index.data_classes()->Get(c);
+                            if (!cls->methods())
+                                continue;
+                            const auto prototype = maybe_get_prototype(cls->class_id());
+                            for (auto m = 0; m < cls->methods()->size(); ++m) {
+                                const auto method = cls->methods()->Get(m);
+                                auto &member = add_class_member(cls->class_id(), method->method_name()->string_view());
+                                const auto name = member.name.Get(isolate);
+                                switch (method->method_kind()) {
+                                    case MethodKindProto::Getter: {
+                                        member.is_getter = true;
+                                        auto getter = get_accessor(prototype, name, get_str);
+                                        if (!getter.IsEmpty())
+                                            member.getter.Reset(isolate, getter);
+                                        break;
+                                    }
+                                    case MethodKindProto::Setter: {
+                                        member.is_setter = true;
+                                        auto setter = get_accessor(prototype, name, set_str);
+                                        if (!setter.IsEmpty())
+                                            member.setter.Reset(isolate, setter);
+                                        break;
+                                    }
+                                    default: {
+                                        member.is_method = true;
+                                        v8::Local<v8::Value> method_val;
+                                        if (!prototype.IsEmpty() && prototype->Get(context, name).ToLocal(&method_val) &&
+                                            method_val->IsFunction())
+                                            member.method.Reset(isolate, method_val.As<v8::Function>());
+                                        break;
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            public:
+                void retain_snapshot(Buffer<u8> snapshot, std::unique_ptr<v8::StartupData> startup_data) {
+                    _snapshot = std::move(snapshot);
+                    _startup_data = std::move(startup_data);
+                }
                 template<data::ObjectType OT>
                 std::optional<ClassId> _get_derived_class_id(v8::Isolate *isolate_, const v8::Local<v8::Value> &value) {
                     V8_SCOPE(isolate_);
@@ -2270,6 +3007,15 @@ namespace estate {
                     assert(it != _object_factory_functions->graft_functions.cend()); //we know the class_id so it should always be found.
                     return it->second;
                 }
+                // The service class exists when the result isn't nullptr, the method exists when its name isn't empty.
+                const ServiceMethod *maybe_get_service_method(ClassId class_id, MethodId method_id) const {
+                    assert(!_moved);
+                    if (class_id >= _service_methods.size() || !_service_methods[class_id].has_value())
+                        return nullptr;
+                    static const ServiceMethod not_found{};
+                    const auto &methods = _service_methods[class_id].value();
+                    return method_id < methods.size() ? &methods[method_id] : &not_found;
+                }
                 const v8::Global<v8::Function> &get_new_function(ClassId class_id) const {
                     const auto it = _object_factory_functions->new_functions.find(class_id);
                     assert(it != _object_factory_functions->new_functions.cend());
@@ -2291,6 +3037,14 @@ namespace estate {
                     assert(!_moved);
                     return _internal_error;
                 }
+                void set_terminated() {
+                    assert(!_moved);
+                    _terminated = true;
+                }
+                [[nodiscard]] bool is_terminated() const {
+                    assert(!_moved);
+                    return _terminated;
+                }
                 const WorkerIndexProto &get_worker_index() const {
                     assert(!_moved);
                     return *_worker_index.get_flatbuffer();
@@ -2311,48 +3065,39 @@ namespace estate {
                     assert(!_moved);
                     return _parent_context;
                 }
+                // The heap V8 has committed for the isolate, which is what the engine pool budgets by.
+                [[nodiscard]] size_t get_heap_size() const {
+                    v8::HeapStatistics heap_statistics{};
+                    _isolate->GetHeapStatistics(&heap_statistics);
+                    return heap_statistics.total_heap_size();
+                }
                 [[nodiscard]] WorkerVersion worker_version() const {
                     assert(!_moved);
                     return _worker_version;
                 }
-                [[nodiscard]] bool service_has_method(ClassId class_id, const std::string &name) {
-                    const auto methods = get_service_methods(class_id);
-                    if (!methods)
-                        return false;
-                    return methods->find(name) != methods->end();
-                }
-                [[nodiscard]] bool object_has_method(ClassId class_id, const std::string &name) {
-                    const auto methods = get_object_methods(class_id);
-                    if (!methods)
-                        return false;
-                    auto it = methods->find(name);
-                    return it != methods->end();
-                }
-                [[nodiscard]] bool object_has_setter_method(ClassId class_id, const std::string &name) {
-                    const auto methods = get_object_methods(class_id);
-                    if (!methods)
-                        return false;
-                    auto it = methods->find(name);
-                    while (it != methods->end()) {
-                        if (it->second == MethodKindProto::Setter)
-                            return true;
-                        ++it;
+                /* The method, getter, or setter named by an interceptor's property name, without converting the name to a
+                 * string. Names are compared by hash then identity, V8 internalizes property keys so they're the same handle. */
+                const ClassMember *maybe_get_class_member(ClassId class_id, const v8::Local<v8::Name> &name) const {
+                    assert(!_moved);
+                    if (class_id >= _class_members.size())
+                        return nullptr;
+                    const auto hash = name->GetIdentityHash();
+                    for (const auto &member: _class_members[class_id]) {
+                        if (member.hash == hash && (member.name == name || member.name.Get(_isolate)->StrictEquals(name)))
+                            return &member;
                     }
-                    return false;
+                    return nullptr;
                 }
-                [[nodiscard]] std::optional<MethodKindProto> object_has_getter_or_normal_method(ClassId class_id, const std::string &name) {
-                    const auto methods = get_object_methods(class_id);
-                    if (!methods)
-                        return std::nullopt;
-                    auto it = methods->find(name);
-                    while (it != methods->end()) {
-                        if (it->second == MethodKindProto::Getter)
-                            return MethodKindProto::Getter;
-                        if (it->second == MethodKindProto::Normal)
-                            return MethodKindProto::Normal;
-                        ++it;
-                    }
-                    return std::nullopt;
+                [[nodiscard]] bool is_primary_key_name(const v8::Local<v8::Name> &name) const {
+                    assert(!_moved);
+                    return _primary_key_name == name || _primary_key_name.Get(_isolate)->StrictEquals(name);
+                }
+                // The class prototype the member table was resolved against.
+                [[nodiscard]] v8::Local<v8::Object> maybe_get_prototype(ClassId class_id) const {
+                    const auto it = _object_factory_functions->prototypes.find(class_id);
+                    if (it == _object_factory_functions->prototypes.cend())
+                        return {};
+                    return it->second.Get(_isolate);
                 }
                 template<data::ClassType CT>
                 [[nodiscard]] std::variant<ClassId, ClassLookupCode> get_class_id(const std::string_view class_name) {
@@ -2428,76 +3173,6 @@ namespace estate {
                         }
                     }
                 }
-                const std::set<std::string> *get_service_methods(ClassId class_id) {
-                    auto it = _service_method_sets.find(class_id);
-                    if (it != _service_method_sets.end()) {
-                        return it->second.has_value() ?
-                               &it->second.value() :
-                               nullptr;
-                    }
-
-                    const auto &worker_index = this->get_worker_index();
-
-                    if (!worker_index.service_classes() || !worker_index.service_classes()->size()) {
-                        _service_method_sets[class_id] = std::nullopt;
-                        return nullptr;
-                    }
-
-                    std::set<std::string> methods{};
-                    for (auto c = 0; c < worker_index.service_classes()->size(); ++c) {
-                        auto clazz = worker_index.service_classes()->Get(c);
-
-                        if (clazz->class_id() == class_id) {
-                            if (clazz->methods() && clazz->methods()->size()) {
-                                for (auto m = 0; m < clazz->methods()->size(); ++m) {
-                                    auto method = clazz->methods()->Get(m);
-                                    std::string name = method->method_name()->str();
-                                    methods.insert(std::move(name));
-                                }
-                            }
-                            break;
-                        }
-                    }
-
-                    _service_method_sets[class_id] = std::move(methods);
-                    return &_service_method_sets[class_id].value();
-                }
-                const std::multimap<std::string, MethodKindProto> *get_object_methods(ClassId class_id) {
-                    auto it = _object_method_maps.find(class_id);
-                    if (it != _object_method_maps.end()) {
-                        return it->second.has_value() ?
-                               &it->second.value() :
-                               nullptr;
-                    }
-
-                    const auto &worker_index = this->get_worker_index();
-
-                    if (!worker_index.data_classes() || !worker_index.data_classes()->size()) {
-                        _object_method_maps[class_id] = std::nullopt;
-                        return nullptr;
-                    }
-
-                    std::multimap<std::string, MethodKindProto> methods{};
-                    for (auto c = 0; c < worker_index.data_classes()->size(); ++c) {
-                        auto clazz = worker_index.data_classes()->Get(c);
-
-                        if (clazz->class_id() == class_id) {
-                            if (clazz->methods() && clazz->methods()->size()) {
-                                for (auto m = 0; m < clazz->methods()->size(); ++m) {
-                                    auto method = clazz->methods()->Get(m);
-                                    methods.insert(std::make_pair(
-                                            method->method_name()->str(),
-                                            method->method_kind()
-                                    ));
-                                }
-                            }
-                            break;
-                        }
-                    }
-
-                    _object_method_maps[class_id] = std::move(methods);
-                    return &_object_method_maps[class_id].value();
-                }
             };
             struct GeneratedFactoryCode {
                 std::string file_name;
@@ -2597,19 +3272,151 @@ namespace estate {
                         specifier_path = referrer_module_def.directory / specifier_path;
                     }
 
-                    assert(specifier_path.is_absolute());
-                    specifier_path = std::filesystem::weakly_canonical(specifier_path);
+                    assert(specifier_path.is_absolute());
+                    specifier_path = std::filesystem::weakly_canonical(specifier_path);
+                    {
+                        std::string specifier_path_str{specifier_path.string()};
+                        const auto user_ident_it = _user_module_name_identity_hash.find(specifier_path_str);
+                        if (user_ident_it == _user_module_name_identity_hash.cend())
+                            return std::nullopt; //not found
+                        const auto module_def_it = _identity_hash_module_def.find(user_ident_it->second);
+                        assert(module_def_it != _identity_hash_module_def.cend());
+                        return module_def_it->second;
+                    }
+                }
+            };
+
+            static bool use_snapshots{false};
+            static bool use_code_cache{false};
+
+            /* Terminates JavaScript calls that run past their wall-clock or CPU-time budget. One thread polls the watched calls
+             * every check interval and calls TerminateExecution on the isolate of any call that has run over. */
+            class ExecutionWatchdog {
+                using Clock = std::chrono::steady_clock;
+                struct WatchedCall {
+                    v8::Isolate *isolate;
+                    Clock::time_point wall_deadline;
+                    std::optional<clockid_t> maybe_cpu_clock;
+                    u64 cpu_deadline_ns;
+                    bool timed_out{false};
+                };
+                using WatchedCalls = std::list<WatchedCall>;
+
+                const u32 _max_call_wall_ms;
+                const u32 _max_call_cpu_ms;
+                const std::chrono::milliseconds _check_interval;
+                std::mutex _mutex{};
+                std::condition_variable _cv{};
+                WatchedCalls _calls{};
+                bool _stopping{false};
+                std::thread _thread;
+
+                static std::optional<u64> get_cpu_time_ns(clockid_t clock) {
+                    timespec ts{};
+                    if (clock_gettime(clock, &ts) != 0)
+                        return std::nullopt;
+                    return static_cast<u64>(ts.tv_sec) * 1000000000 + static_cast<u64>(ts.tv_nsec);
+                }
+                void run() {
+                    std::unique_lock<std::mutex> lck(_mutex);
+                    while (!_stopping) {
+                        if (_calls.empty()) {
+                            _cv.wait(lck);
+                            continue;
+                        }
+                        _cv.wait_for(lck, _check_interval);
+                        const auto now = Clock::now();
+                        for (auto &call : _calls) {
+                            if (call.timed_out)
+                                continue;
+                            bool over = _max_call_wall_ms > 0 && now >= call.wall_deadline;
+                            if (!over && call.maybe_cpu_clock.has_value()) {
+                                auto maybe_cpu_time = get_cpu_time_ns(call.maybe_cpu_clock.value());
+                                over = maybe_cpu_time.has_value() && maybe_cpu_time.value() >= call.cpu_deadline_ns;
+                            }
+                            if (over) {
+                                call.timed_out = true;
+                                call.isolate->TerminateExecution();
+                            }
+                        }
+                    }
+                }
+            public:
+                // Unwatches the call when destroyed. A call that was terminated has its termination cancelled so the
+                // isolate can unwind and be discarded normally.
+                class Watch {
+                    ExecutionWatchdog *_watchdog;
+                    WatchedCalls::iterator _it;
+                    bool _timed_out{false};
+                public:
+                    Watch(ExecutionWatchdog *watchdog, WatchedCalls::iterator it) : _watchdog(watchdog), _it(it) {}
+                    Watch(const Watch &) = delete;
+                    Watch(Watch &&) = delete;
+                    ~Watch() {
+                        release();
+                    }
+                    // Stops watching and returns whether the call was terminated.
+                    bool release() {
+                        if (_watchdog) {
+                            {
+                                std::unique_lock<std::mutex> lck(_watchdog->_mutex);
+                                _timed_out = _it->timed_out;
+                                if (_timed_out)
+                                    _it->isolate->CancelTerminateExecution();
+                                _watchdog->_calls.erase(_it);
+                            }
+                            _watchdog = nullptr;
+                        }
+                        return _timed_out;
+                    }
+                };
+
+                ExecutionWatchdog(u32 max_call_wall_ms, u32 max_call_cpu_ms, u32 check_interval_ms) :
+                        _max_call_wall_ms(max_call_wall_ms), _max_call_cpu_ms(max_call_cpu_ms),
+                        _check_interval(std::max<u32>(check_interval_ms, 1)) {
+                    _thread = std::thread([this]() { run(); });
+                }
+                ~ExecutionWatchdog() {
                     {
-                        std::string specifier_path_str{specifier_path.string()};
-                        const auto user_ident_it = _user_module_name_identity_hash.find(specifier_path_str);
-                        if (user_ident_it == _user_module_name_identity_hash.cend())
-                            return std::nullopt; //not found
-                        const auto module_def_it = _identity_hash_module_def.find(user_ident_it->second);
-                        assert(module_def_it != _identity_hash_module_def.cend());
-                        return module_def_it->second;
+                        std::unique_lock<std::mutex> lck(_mutex);
+                        _stopping = true;
+                    }
+                    _cv.notify_all();
+                    _thread.join();
+                }
+                // Watches the JavaScript call about to be made on this thread in the isolate.
+                std::unique_ptr<Watch> watch(v8::Isolate *isolate) {
+                    std::optional<clockid_t> maybe_cpu_clock{};
+                    u64 cpu_deadline_ns{0};
+                    if (_max_call_cpu_ms > 0) {
+                        clockid_t clock;
+                        if (pthread_getcpuclockid(pthread_self(), &clock) == 0) {
+                            auto maybe_cpu_time = get_cpu_time_ns(clock);
+                            if (maybe_cpu_time.has_value()) {
+                                maybe_cpu_clock = clock;
+                                cpu_deadline_ns = maybe_cpu_time.value() + static_cast<u64>(_max_call_cpu_ms) * 1000000;
+                            }
+                        }
                     }
+                    std::unique_lock<std::mutex> lck(_mutex);
+                    _calls.push_front(WatchedCall{isolate,
+                                                  Clock::now() + std::chrono::milliseconds(_max_call_wall_ms),
+                                                  maybe_cpu_clock,
+                                                  cpu_deadline_ns});
+                    auto it = _calls.begin();
+                    lck.unlock();
+                    _cv.notify_one();
+                    return std::make_unique<Watch>(this, it);
                 }
             };
+            static std::unique_ptr<ExecutionWatchdog> execution_watchdog{};
+
+            /* V8 code caches for a worker version's modules keyed by file name id. The generated factory module is keyed by
+             * ESTATE_FACTORY_MODULE_CODE_CACHE_ID. */
+            struct ModuleCodeCaches {
+                std::map<u16, Buffer<u8>> existing{}; //consumed when compiling
+                std::map<u16, std::string> created{}; //for modules that had no cache or whose cache was rejected
+            };
 
             /* V8 ArrayBuffer allocator that disables all allocation. */
             class DisabledArrayBufferAllocator : public v8::ArrayBuffer::Allocator {
@@ -2710,7 +3517,8 @@ namespace estate {
                     static const std::map<std::string, std::string> base_replacements{
                             {base_repl("EXISTING_WORKER_OBJECT_CTOR"),     ESTATE_EXISTING_DATA_CTOR_STR},
                             {base_repl("PASSTHROUGH_CLASS_NAME_PREFIX"), ESTATE_PASSTHROUGH_CLASS_NAME_PREFIX},
-                            {base_repl("GRAFT_FUNC_PREFIX"),             ESTATE_GRAFT_FUNC_PREFIX}
+                            {base_repl("GRAFT_FUNC_PREFIX"),             ESTATE_GRAFT_FUNC_PREFIX},
+                            {base_repl("PROTOTYPE_PREFIX"),              ESTATE_PROTOTYPE_PREFIX}
                     };
                     static const std::string path{"js/Data-factory.js.mustache"};
                     return GetTemplateCode(base_replacements, path);
@@ -2728,7 +3536,8 @@ namespace estate {
                             {base_repl("EXISTING_WORKER_SERVICE_CTOR"),    ESTATE_EXISTING_SERVICE_CTOR_STR},
                             {base_repl("PASSTHROUGH_CLASS_NAME_PREFIX"), ESTATE_PASSTHROUGH_CLASS_NAME_PREFIX},
                             {base_repl("GRAFT_FUNC_PREFIX"),             ESTATE_GRAFT_FUNC_PREFIX},
-                            {base_repl("NEW_FUNC_PREFIX"),               ESTATE_NEW_FUNC_PREFIX}
+                            {base_repl("NEW_FUNC_PREFIX"),               ESTATE_NEW_FUNC_PREFIX},
+                            {base_repl("PROTOTYPE_PREFIX"),              ESTATE_PROTOTYPE_PREFIX}
                     };
                     static const std::string path{"js/Service-factory.js.mustache"};
                     return GetTemplateCode(base_replacements, path);
@@ -2800,29 +3609,83 @@ namespace estate {
 
                     return std::move(gen);
                 }
-            public:
-                static void print_constraints(const std::string& label, const LogContext& log_context, const v8::Isolate::CreateParams& create_params) {
-                    const auto &c = create_params.constraints;
-                    log_trace(log_context, "{} Constraints: max_semi_space_size_in_kb {} code_range_size_in_bytes {} "
-                                           "max_old_generation_size_in_bytes {} max_old_space_size {} "
-                                           "max_young_generation_size_in_bytes {} max_zone_pool_size {}", label,
-                                           c.max_semi_space_size_in_kb(),
-                              c.code_range_size_in_bytes(),
-                              c.max_old_generation_size_in_bytes(),
-                              c.max_old_space_size(),
-                              c.max_young_generation_size_in_bytes(),
-                              c.max_zone_pool_size());
+                static v8::MaybeLocal<v8::Value> EvaluateServerInternalModule(v8::Local<v8::Context> context, v8::Local<v8::Module> module) {
+                    auto isolate = context->GetIsolate();
+                    //Constructors for existing objects
+                    V8_EXPORT_CTOR(module, native::runtime_internal, ESTATE_EXISTING_SERVICE_CTOR, service);
+                    V8_EXPORT_CTOR(module, native::runtime_internal, ESTATE_EXISTING_DATA_CTOR, object);
+                    return v8::MaybeLocal<v8::Value>(v8::Boolean::New(isolate, true));
                 }
-                static EngineResultCode<EngineU>
-                CreateEngine(const LogContext &log_context, Buffer<WorkerIndexProto> worker_index, Buffer<EngineSourceProto> engine_source,
-                             size_t max_heap_size) {
-                    using Result = EngineResultCode<EngineU>;
+                static v8::MaybeLocal<v8::Value> EvaluateServerModule(v8::Local<v8::Context> context, v8::Local<v8::Module> module) {
+                    auto isolate = context->GetIsolate();
 
-                    assert(max_heap_size > 0);
+                    V8_EXPORT_FUNCTION(module, native::runtime, ESTATE_NEW_MESSAGE_CTOR);
+                    V8_EXPORT_FUNCTION(module, native::runtime, ESTATE_CREATE_UUID_FUNCTION);
+                    V8_EXPORT_CTOR(module, native::runtime, ESTATE_NEW_SERVICE_CTOR, service);
+                    V8_EXPORT_CTOR(module, native::runtime, ESTATE_NEW_DATA_CTOR, object);
 
-                    const char *FROM = "CreateEngine";
+                    //Server object
+                    {
+                        auto server_template = v8::ObjectTemplate::New(isolate);
+
+                        V8_DEFINE_OBJECT_FUNCTION(server_template, native::runtime::system, ESTATE_GET_SERVICE_FUNCTION);
+                        V8_DEFINE_OBJECT_FUNCTION(server_template, native::runtime::system, ESTATE_REVERT_FUNCTION);
+                        V8_DEFINE_OBJECT_FUNCTION(server_template, native::runtime::system, ESTATE_GET_DATA_FUNCTION);
+                        V8_DEFINE_OBJECT_FUNCTION_N(server_template, native::runtime::system, ESTATE_DELETE_FUNCTION,
+                                                    ESTATE_DELETE_FUNCTION_STR);
+                        V8_DEFINE_OBJECT_FUNCTION(server_template, native::runtime::system, ESTATE_SAVE_DATA_GRAPHS_FUNCTION);
+                        V8_DEFINE_OBJECT_FUNCTION(server_template, native::runtime::system, ESTATE_SAVE_DATA_FUNCTION);
+                        V8_DEFINE_OBJECT_FUNCTION(server_template, native::runtime::system, ESTATE_SEND_MESSAGE_FUNCTION);
+
+                        V8_EXPORT_OBJECT(module, server_template, ESTATE_SYSTEM_OBJECT_NAME);
+                    }
+
+                    return v8::MaybeLocal<v8::Value>(v8::Boolean::New(isolate, true));
+                }
+                // Every native address reachable from the engine context. A snapshot can only be created from, and
+                // restored into, an isolate that was given this exact list.
+                static const intptr_t *GetExternalReferences() {
+                    static const intptr_t external_references[] = {
+                            reinterpret_cast<intptr_t>(&EngineFactory::EvaluateServerInternalModule),
+                            reinterpret_cast<intptr_t>(&EngineFactory::EvaluateServerModule),
+                            reinterpret_cast<intptr_t>(&native::noop),
+                            reinterpret_cast<intptr_t>(&native::console::ESTATE_CONSOLE_LOG_FUNCTION),
+                            reinterpret_cast<intptr_t>(&native::console::ESTATE_CONSOLE_ERROR_FUNCTION),
+                            reinterpret_cast<intptr_t>(&native::runtime::ESTATE_NEW_MESSAGE_CTOR),
+                            reinterpret_cast<intptr_t>(&native::runtime::ESTATE_NEW_DATA_CTOR),
+                            reinterpret_cast<intptr_t>(&native::runtime::ESTATE_NEW_SERVICE_CTOR),
+                            reinterpret_cast<intptr_t>(&native::runtime::ESTATE_CREATE_UUID_FUNCTION),
+                            reinterpret_cast<intptr_t>(&native::runtime::system::ESTATE_GET_SERVICE_FUNCTION),
+                            reinterpret_cast<intptr_t>(&native::runtime::system::ESTATE_REVERT_FUNCTION),
+                            reinterpret_cast<intptr_t>(&native::runtime::system::ESTATE_GET_DATA_FUNCTION),
+                            reinterpret_cast<intptr_t>(&native::runtime::system::ESTATE_DELETE_FUNCTION),
+                            reinterpret_cast<intptr_t>(&native::runtime::system::ESTATE_SAVE_DATA_GRAPHS_FUNCTION),
+                            reinterpret_cast<intptr_t>(&native::runtime::system::ESTATE_SAVE_DATA_FUNCTION),
+                            reinterpret_cast<intptr_t>(&native::runtime::system::ESTATE_SEND_MESSAGE_FUNCTION),
+                            reinterpret_cast<intptr_t>(&native::runtime_internal::ESTATE_EXISTING_DATA_CTOR),
+                            reinterpret_cast<intptr_t>(&native::runtime_internal::ESTATE_EXISTING_SERVICE_CTOR),
+                            reinterpret_cast<intptr_t>(&native::object::on_service_property_get),
+                            reinterpret_cast<intptr_t>(&native::object::on_service_property_set),
+                            reinterpret_cast<intptr_t>(&native::object::on_service_property_delete),
+                            reinterpret_cast<intptr_t>(&native::object::on_object_property_get),
+                            reinterpret_cast<intptr_t>(&native::object::on_object_property_set),
+                            reinterpret_cast<intptr_t>(&native::object::on_object_property_delete),
+                            0
+                    };
+                    return external_references;
+                }
+                static v8::ScriptCompiler::CachedData *GetCachedData(ModuleCodeCaches *code_caches, u16 file_name_id) {
+                    if (!code_caches)
+                        return nullptr;
+                    const auto it = code_caches->existing.find(file_name_id);
+                    if (it == code_caches->existing.cend())
+                        return nullptr;
+                    return new v8::ScriptCompiler::CachedData(it->second.as_u8(), static_cast<int>(it->second.size()),
+                                                              v8::ScriptCompiler::CachedData::BufferNotOwned);
+                }
+                static v8::Isolate::CreateParams CreateIsolateParams(const LogContext &log_context, size_t max_heap_size) {
+                    assert(max_heap_size > 0);
 
-                    //create the isolate, global object, and context
                     v8::Isolate::CreateParams create_params;
 
                     //TODO: Allow ArrayBuffer allocation but make it limited to a max memory value from config.
@@ -2835,11 +3698,29 @@ namespace estate {
                             create_params.constraints.max_old_generation_size_in_bytes();
                     log_trace(log_context, "Total allocatable memory: {} bytes", total);
 
-                    auto allocator = create_params.array_buffer_allocator;
-                    auto isolate = v8::Isolate::New(create_params);
-                    v8::HandleScope handle_scope(isolate);
-                    auto context = v8::Context::New(isolate, 0, v8::ObjectTemplate::New(isolate));
-                    v8::Context::Scope context_scope(context);
+                    return create_params;
+                }
+            public:
+                static void print_constraints(const std::string& label, const LogContext& log_context, const v8::Isolate::CreateParams& create_params) {
+                    const auto &c = create_params.constraints;
+                    log_trace(log_context, "{} Constraints: max_semi_space_size_in_kb {} code_range_size_in_bytes {} "
+                                           "max_old_generation_size_in_bytes {} max_old_space_size {} "
+                                           "max_young_generation_size_in_bytes {} max_zone_pool_size {}", label,
+                                           c.max_semi_space_size_in_kb(),
+                              c.code_range_size_in_bytes(),
+                              c.max_old_generation_size_in_bytes(),
+                              c.max_old_space_size(),
+                              c.max_young_generation_size_in_bytes(),
+                              c.max_zone_pool_size());
+                }
+                // Builds the kernel modules, loads and evaluates the worker's code, and returns the object factory functions.
+                static EngineResultCode<ObjectFactoryFunctionsU>
+                InitializeContext(const LogContext &log_context, v8::Isolate *isolate, v8::Local<v8::Context> context,
+                                  const BufferView<WorkerIndexProto> worker_index, const BufferView<EngineSourceProto> engine_source,
+                                  ModuleCodeCaches *code_caches) {
+                    using Result = EngineResultCode<ObjectFactoryFunctionsU>;
+
+                    const char *FROM = "InitializeContext";
 
                     //////////////////////////////////////////////////////////////////////////////
                     // Create the module cache
@@ -2862,13 +3743,7 @@ namespace estate {
                             isolate,
                             server_internal_module_name,
                             server_internal_module_exports,
-                            [](v8::Local<v8::Context> context, v8::Local<v8::Module> module) {
-                                auto isolate = context->GetIsolate();
-                                //Constructors for existing objects
-                                V8_EXPORT_CTOR(module, native::runtime_internal, ESTATE_EXISTING_SERVICE_CTOR, service);
-                                V8_EXPORT_CTOR(module, native::runtime_internal, ESTATE_EXISTING_DATA_CTOR, object);
-                                return v8::MaybeLocal<v8::Value>(v8::Boolean::New(isolate, true));
-                            });
+                            &EngineFactory::EvaluateServerInternalModule);
                     //Instanciate and evaluate
                     server_internal_module->InstantiateModule(context, [](v8::Local<v8::Context>, v8::Local<v8::String>, v8::Local<v8::Module>) {
                         assert(false); //shouldn't import anything
@@ -2902,32 +3777,7 @@ namespace estate {
                             isolate,
                             server_module_name,
                             server_module_exports,
-                            [](v8::Local<v8::Context> context, v8::Local<v8::Module> module) {
-                                auto isolate = context->GetIsolate();
-
-                                V8_EXPORT_FUNCTION(module, native::runtime, ESTATE_NEW_MESSAGE_CTOR);
-                                V8_EXPORT_FUNCTION(module, native::runtime, ESTATE_CREATE_UUID_FUNCTION);
-                                V8_EXPORT_CTOR(module, native::runtime, ESTATE_NEW_SERVICE_CTOR, service);
-                                V8_EXPORT_CTOR(module, native::runtime, ESTATE_NEW_DATA_CTOR, object);
-
-                                //Server object
-                                {
-                                    auto server_template = v8::ObjectTemplate::New(isolate);
-
-                                    V8_DEFINE_OBJECT_FUNCTION(server_template, native::runtime::system, ESTATE_GET_SERVICE_FUNCTION);
-                                    V8_DEFINE_OBJECT_FUNCTION(server_template, native::runtime::system, ESTATE_REVERT_FUNCTION);
-                                    V8_DEFINE_OBJECT_FUNCTION(server_template, native::runtime::system, ESTATE_GET_DATA_FUNCTION);
-                                    V8_DEFINE_OBJECT_FUNCTION_N(server_template, native::runtime::system, ESTATE_DELETE_FUNCTION,
-                                                                ESTATE_DELETE_FUNCTION_STR);
-                                    V8_DEFINE_OBJECT_FUNCTION(server_template, native::runtime::system, ESTATE_SAVE_DATA_GRAPHS_FUNCTION);
-                                    V8_DEFINE_OBJECT_FUNCTION(server_template, native::runtime::system, ESTATE_SAVE_DATA_FUNCTION);
-                                    V8_DEFINE_OBJECT_FUNCTION(server_template, native::runtime::system, ESTATE_SEND_MESSAGE_FUNCTION);
-
-                                    V8_EXPORT_OBJECT(module, server_template, ESTATE_SYSTEM_OBJECT_NAME);
-                                }
-
-                                return v8::MaybeLocal<v8::Value>(v8::Boolean::New(isolate, true));
-                            });
+                            &EngineFactory::EvaluateServerModule);
                     //Instanciate and evaluate the server module
                     server_module->InstantiateModule(context, [](v8::Local<v8::Context>, v8::Local<v8::String>, v8::Local<v8::Module>) {
                         assert(false); //shouldn't import anything
@@ -2995,6 +3845,7 @@ namespace estate {
 
                     // Build the module paths
                     std::unordered_map<std::string_view, std::string_view> file_code{};
+                    std::unordered_map<std::string_view, u16> file_ids{};
                     std::unordered_map<std::string_view, std::string> file_module_name{};
                     for (int i = 0; i < worker_index->file_names()->size(); ++i) {
                         auto f = worker_index->file_names()->Get(i);
@@ -3005,14 +3856,34 @@ namespace estate {
                             return Result::Error(Code::ScriptEngine_BadFileId);
                         }
                         file_code[file_name] = engine_source->code_files()->Get(file_id - 1)->string_view();
+                        file_ids[file_name] = file_id;
                     }
 
                     const auto worker_name = worker_index->worker_name()->string_view();
                     //note: the synthetic (C++ backed) modules don't have a source.
 
+                    /* Creates the code cache for a module that had none or whose cache was rejected. It has to be created straight after
+                     * compiling because the module's unbound script is gone once it's instantiated. */
+                    const auto create_code_cache = [&](u16 file_id, v8::Local<v8::Module> module, bool cache_rejected) {
+                        if (!code_caches)
+                            return;
+                        if (cache_rejected)
+                            log_warn(log_context, "The code cache for file id {} was rejected, it will be regenerated", file_id);
+                        else if (code_caches->existing.contains(file_id))
+                            return;
+                        std::unique_ptr<v8::ScriptCompiler::CachedData> cached_data{
+                                v8::ScriptCompiler::CreateCodeCache(module->GetUnboundModuleScript())};
+                        if (cached_data && cached_data->length > 0)
+                            code_caches->created[file_id] = std::string{reinterpret_cast<const char *>(cached_data->data),
+                                                                        static_cast<size_t>(cached_data->length)};
+                    };
+
                     // Compile all the user modules and load them into the module cache
                     for (const auto[file_name, code]: file_code) {
-                        V8_COMPILE_MODULE(module, worker_name, code, file_name);
+                        const auto file_id = file_ids[file_name];
+                        bool cache_rejected{false};
+                        V8_COMPILE_MODULE(module, worker_name, code, file_name, GetCachedData(code_caches, file_id), cache_rejected);
+                        create_code_cache(file_id, module, cache_rejected);
                         auto worked = module_cache.add_module(false, file_name, module);
                         if (!worked) {
                             const auto error = worked.get_error();
@@ -3022,8 +3893,11 @@ namespace estate {
                     }
 
                     //Generate, compile, and cache the factory module
-                    const auto factory_code = GenerateRuntimeCode(worker_index.get_view(), module_cache);
-                    V8_COMPILE_MODULE(factory_module, worker_name, factory_code.code, factory_code.file_name);
+                    const auto factory_code = GenerateRuntimeCode(worker_index, module_cache);
+                    bool factory_cache_rejected{false};
+                    V8_COMPILE_MODULE(factory_module, worker_name, factory_code.code, factory_code.file_name,
+                                      GetCachedData(code_caches, ESTATE_FACTORY_MODULE_CODE_CACHE_ID), factory_cache_rejected);
+                    create_code_cache(ESTATE_FACTORY_MODULE_CODE_CACHE_ID, factory_module, factory_cache_rejected);
                     {
                         const auto worked = module_cache.add_module(true, factory_code.file_name, factory_module);
                         assert(worked);
@@ -3072,7 +3946,13 @@ namespace estate {
                         }
 
                         v8::TryCatch try_catch(isolate);
+                        auto maybe_watch = execution_watchdog ? execution_watchdog->watch(isolate) : nullptr;
                         auto unused = module->Evaluate(context);
+                        if (maybe_watch && maybe_watch->release()) {
+                            log_error(log_context, "Failed to evaluate module {} because it exceeded its execution time limit",
+                                      module_def.file_name);
+                            return Result::Error(Code::ScriptEngine_ExecutionTimeout);
+                        }
                         if (try_catch.HasCaught()) {
                             auto ex = create_script_exception(log_context, isolate, try_catch);
                             log_script_exception(log_context, ex);
@@ -3102,6 +3982,10 @@ namespace estate {
                                     ns->Get(context, V8_STR(fmt::format(ESTATE_NEW_FUNC_FORMAT,
                                                                         class_id))).ToLocalChecked());
                             object_factory_functions->new_functions[class_id].Reset(isolate, new_func);
+                            auto prototype = v8::Local<v8::Object>::Cast(
+                                    ns->Get(context, V8_STR(fmt::format(ESTATE_PROTOTYPE_FORMAT,
+                                                                        class_id))).ToLocalChecked());
+                            object_factory_functions->prototypes[class_id].Reset(isolate, prototype);
                         }
                     }
                     if (worker_index->data_classes()) {
@@ -3111,9 +3995,32 @@ namespace estate {
                                     ns->Get(context, V8_STR(fmt::format(ESTATE_GRAFT_FUNC_FORMAT,
                                                                         class_id))).ToLocalChecked());
                             object_factory_functions->graft_functions[class_id].Reset(isolate, graft_func);
+                            auto prototype = v8::Local<v8::Object>::Cast(
+                                    ns->Get(context, V8_STR(fmt::format(ESTATE_PROTOTYPE_FORMAT,
+                                                                        class_id))).ToLocalChecked());
+                            object_factory_functions->prototypes[class_id].Reset(isolate, prototype);
                         }
                     }
 
+                    return Result::Ok(std::move(object_factory_functions));
+                }
+                static EngineResultCode<EngineU>
+                CreateEngine(const LogContext &log_context, Buffer<WorkerIndexProto> worker_index, Buffer<EngineSourceProto> engine_source,
+                             size_t max_heap_size, ModuleCodeCaches *code_caches) {
+                    using Result = EngineResultCode<EngineU>;
+
+                    //create the isolate, global object, and context
+                    auto create_params = CreateIsolateParams(log_context, max_heap_size);
+                    auto allocator = create_params.array_buffer_allocator;
+                    auto isolate = v8::Isolate::New(create_params);
+                    v8::HandleScope handle_scope(isolate);
+                    auto context = v8::Context::New(isolate, 0, v8::ObjectTemplate::New(isolate));
+                    v8::Context::Scope context_scope(context);
+
+                    UNWRAP_OR_RETURN(object_factory_functions, InitializeContext(log_context, isolate, context,
+                                                                                 worker_index.get_view(), engine_source.get_view(),
+                                                                                 code_caches));
+
                     return Result::Ok(std::make_unique<Engine>(
                             std::move(worker_index),
                             isolate,
@@ -3121,6 +4028,147 @@ namespace estate {
                             std::move(context),
                             std::move(object_factory_functions)));
                 }
+                /* Runs the same initialization as CreateEngine inside a SnapshotCreator and serializes the resulting heap.
+                 * The object factory functions are kept as snapshot data in [class_id, graft, new, prototype] quads. The blob is
+                 * prefixed with the V8 version and the layout of that data so a snapshot written by a different V8, or an
+                 * older server, is never deserialized.
+                 * Experimental: V8 CHECK-fails, aborting the process, on heaps it can't serialize (module records among them)
+                 * rather than returning an empty blob, so this only runs behind JavascriptConfig::experimental_use_snapshots. */
+                static const std::string &GetSnapshotVersion() {
+                    static const std::string version{fmt::format("{}/{}", v8::V8::GetVersion(), ESTATE_ENGINE_SNAPSHOT_LAYOUT)};
+                    return version;
+                }
+                static std::optional<std::string>
+                CreateSnapshot(const LogContext &log_context, const BufferView<WorkerIndexProto> worker_index,
+                               const BufferView<EngineSourceProto> engine_source) {
+                    v8::SnapshotCreator creator{GetExternalReferences()};
+                    auto isolate = creator.GetIsolate();
+                    {
+                        v8::HandleScope handle_scope(isolate);
+                        auto context = v8::Context::New(isolate, 0, v8::ObjectTemplate::New(isolate));
+                        v8::Context::Scope context_scope(context);
+
+                        auto object_factory_functions_r = InitializeContext(log_context, isolate, context, worker_index, engine_source, nullptr);
+                        if (!object_factory_functions_r) {
+                            log_warn(log_context, "Unable to create the engine snapshot because the context failed to initialize");
+                            return std::nullopt;
+                        }
+                        auto object_factory_functions = std::move(object_factory_functions_r.unwrap());
+
+                        const auto &graft_functions = object_factory_functions->graft_functions;
+                        const auto &new_functions = object_factory_functions->new_functions;
+                        const auto &prototypes = object_factory_functions->prototypes;
+                        auto functions = v8::Array::New(isolate, static_cast<int>(graft_functions.size() * 4));
+                        u32 i = 0;
+                        for (const auto &[class_id, graft_func]: graft_functions) {
+                            const auto new_func_it = new_functions.find(class_id);
+                            functions->Set(context, i++, v8::Integer::NewFromUnsigned(isolate, class_id)).Check();
+                            functions->Set(context, i++, graft_func.Get(isolate)).Check();
+                            functions->Set(context, i++, new_func_it == new_functions.cend() ?
+                                                         v8::Local<v8::Value>{v8::Undefined(isolate)} :
+                                                         v8::Local<v8::Value>{new_func_it->second.Get(isolate)}).Check();
+                            const auto prototype_it = prototypes.find(class_id);
+                            functions->Set(context, i++, prototype_it == prototypes.cend() ?
+                                                         v8::Local<v8::Value>{v8::Undefined(isolate)} :
+                                                         v8::Local<v8::Value>{prototype_it->second.Get(isolate)}).Check();
+                        }
+                        const auto index = creator.AddData(context, functions);
+                        assert(index == 0);
+                        creator.SetDefaultContext(context);
+                    } //all the globals in object_factory_functions are released here, CreateBlob requires it
+                    auto blob = creator.CreateBlob(v8::SnapshotCreator::FunctionCodeHandling::kKeep);
+                    if (!blob.data || blob.raw_size <= 0) {
+                        log_warn(log_context, "Unable to create the engine snapshot, V8 returned an empty blob");
+                        return std::nullopt;
+                    }
+                    std::string snapshot{GetSnapshotVersion()};
+                    snapshot.push_back('\0');
+                    snapshot.append(blob.data, blob.raw_size);
+                    delete[] blob.data;
+                    log_trace(log_context, "Created a {} byte engine snapshot", snapshot.size());
+                    return snapshot;
+                }
+                /* Compiles and evaluates the worker's modules in a throwaway isolate and returns a code cache for each of them.
+                 * Returns no caches if the modules couldn't be evaluated. */
+                static std::map<u16, std::string>
+                CreateCodeCaches(const LogContext &log_context, const BufferView<WorkerIndexProto> worker_index,
+                                 const BufferView<EngineSourceProto> engine_source, size_t max_heap_size) {
+                    auto create_params = CreateIsolateParams(log_context, max_heap_size);
+                    auto allocator = create_params.array_buffer_allocator;
+                    auto isolate = v8::Isolate::New(create_params);
+                    ModuleCodeCaches code_caches{};
+                    {
+                        v8::HandleScope handle_scope(isolate);
+                        auto context = v8::Context::New(isolate, 0, v8::ObjectTemplate::New(isolate));
+                        v8::Context::Scope context_scope(context);
+                        if (!InitializeContext(log_context, isolate, context, worker_index, engine_source, &code_caches)) {
+                            log_warn(log_context, "Unable to create code caches because the context failed to initialize");
+                            code_caches.created.clear();
+                        }
+                    }
+                    isolate->Dispose();
+                    delete allocator;
+                    return std::move(code_caches.created);
+                }
+                /* Creates an Engine by deserializing a snapshot made by CreateSnapshot. Returns nullopt when the snapshot
+                 * wasn't made by this V8 version or didn't contain the factory functions. */
+                static std::optional<EngineU>
+                CreateEngineFromSnapshot(const LogContext &log_context, Buffer<WorkerIndexProto> worker_index, Buffer<u8> snapshot,
+                                         size_t max_heap_size) {
+                    const std::string_view version{GetSnapshotVersion()};
+                    if (snapshot.size() <= version.size() ||
+                        std::string_view{snapshot.as_char(), version.size()} != version ||
+                        snapshot.as_char()[version.size()] != '\0') {
+                        log_warn(log_context, "Ignoring an engine snapshot that was created by a different version of V8 or layout");
+                        return std::nullopt;
+                    }
+
+                    auto startup_data = std::make_unique<v8::StartupData>();
+                    startup_data->data = snapshot.as_char() + version.size() + 1;
+                    startup_data->raw_size = static_cast<int>(snapshot.size() - version.size() - 1);
+
+                    auto create_params = CreateIsolateParams(log_context, max_heap_size);
+                    create_params.snapshot_blob = startup_data.get();
+                    create_params.external_references = GetExternalReferences();
+                    auto allocator = create_params.array_buffer_allocator;
+                    auto isolate = v8::Isolate::New(create_params);
+                    {
+                        v8::HandleScope handle_scope(isolate);
+                        auto context = v8::Context::New(isolate);
+                        v8::Context::Scope context_scope(context);
+
+                        v8::Local<v8::Array> functions;
+                        if (context->GetDataFromSnapshotOnce<v8::Array>(0).ToLocal(&functions) && functions->Length() % 4 == 0) {
+                            auto object_factory_functions = std::make_unique<ObjectFactoryFunctions>();
+                            for (u32 i = 0; i < functions->Length(); i += 4) {
+                                const auto class_id = static_cast<ClassId>(
+                                        functions->Get(context, i).ToLocalChecked().As<v8::Integer>()->Value());
+                                auto graft_func = functions->Get(context, i + 1).ToLocalChecked().As<v8::Function>();
+                                object_factory_functions->graft_functions[class_id].Reset(isolate, graft_func);
+                                auto new_func = functions->Get(context, i + 2).ToLocalChecked();
+                                if (new_func->IsFunction())
+                                    object_factory_functions->new_functions[class_id].Reset(isolate, new_func.As<v8::Function>());
+                                auto prototype = functions->Get(context, i + 3).ToLocalChecked();
+                                if (prototype->IsObject())
+                                    object_factory_functions->prototypes[class_id].Reset(isolate, prototype.As<v8::Object>());
+                            }
+
+                            auto engine = std::make_unique<Engine>(
+                                    std::move(worker_index),
+                                    isolate,
+                                    allocator,
+                                    std::move(context),
+                                    std::move(object_factory_functions));
+                            engine->retain_snapshot(std::move(snapshot), std::move(startup_data));
+                            return std::move(engine);
+                        }
+                    }
+
+                    log_warn(log_context, "The engine snapshot didn't contain the object factory functions");
+                    isolate->Dispose();
+                    delete allocator;
+                    return std::nullopt;
+                }
             };
             Engine *get_engine(v8::Isolate *isolate_) {
                 V8_SCOPE(isolate_);
@@ -3280,6 +4328,7 @@ namespace estate {
                 std::mutex _worker_id_engine_pool_mutex{};
                 std::unordered_map<WorkerId, EnginePoolS> _worker_id_engine_pool{};
                 size_t _max_heap_size;
+                PoolConfig _engine_pool_config;
             private:
                 EngineResultCode<Buffer<WorkerProcessUserResponseProto>>
                 make_call_service_method_response(v8::Isolate *isolate_,
@@ -3307,7 +4356,8 @@ namespace estate {
                         }
                     }
 
-                    fbs::Builder outer_builder{};
+                    auto buffer_pool = call_context->get_buffer_pool();
+                    PooledBuilder outer_builder{buffer_pool};
 
                     // Get the generated deltas
                     fbs::Offset<fbs::Vector<fbs::Offset<DataDeltaBytesProto>>> delta_bytes_off{};
@@ -3336,8 +4386,6 @@ namespace estate {
                         event_bytes_off = outer_builder.CreateVector(event_bytes_vec);
                     }
 
-                    auto buffer_pool = call_context->get_buffer_pool();
-
                     // Get the console log
                     auto console_log = call_context->get_console_log();
                     fbs::Offset<fbs::Vector<u8>> console_log_vec_off = 0;
@@ -3348,7 +4396,7 @@ namespace estate {
                     }
 
                     // Serialize the method return value
-                    fbs::Builder inner_builder{};
+                    PooledBuilder inner_builder{buffer_pool};
                     ValueUnionProto unused;
                     auto result_off_r = serialize(log_context, isolate, inner_builder, return_value, unused, std::nullopt);
                     if (!result_off_r)
@@ -3366,7 +4414,7 @@ namespace estate {
                             console_log_vec_off
                     );
 
-                    return Result::Ok(finish_and_copy_to_buffer(outer_builder, buffer_pool, response_proto));
+                    return Result::Ok(finish_to_buffer(outer_builder, response_proto));
                 }
                 EnginePoolS get_engine_pool(const WorkerId worker_id) {
                     std::lock_guard<std::mutex> lck(_worker_id_engine_pool_mutex);
@@ -3375,10 +4423,82 @@ namespace estate {
                         auto pool = it->second;
                         return std::move(pool);
                     }
-                    auto engine_pool = std::make_shared<EnginePool>();
+                    auto engine_pool = std::make_shared<EnginePool>(_engine_pool_config, [](EngineU &engine) {
+                        return engine->get_heap_size();
+                    });
                     _worker_id_engine_pool[worker_id] = engine_pool;
                     return std::move(engine_pool);
                 }
+                EngineResultCode<EngineU> create_engine(const LogContext &log_context, storage::ITransactionS txn) {
+                    using Result = EngineResultCode<EngineU>;
+
+                    // Deserialize the Engine from the worker version's snapshot when there is one
+                    if (use_snapshots) {
+                        auto snapshot_r = txn->maybe_get_engine_snapshot();
+                        if (!snapshot_r)
+                            return Result::Error(snapshot_r.get_error());
+                        auto maybe_snapshot = snapshot_r.unwrap();
+                        if (maybe_snapshot.has_value()) {
+                            auto worker_index_r = txn->get_worker_index();
+                            if (!worker_index_r)
+                                return Result::Error(worker_index_r.get_error());
+                            auto maybe_engine = EngineFactory::CreateEngineFromSnapshot(log_context,
+                                                                                        worker_index_r.unwrap(),
+                                                                                        std::move(maybe_snapshot.value()),
+                                                                                        this->_max_heap_size);
+                            if (maybe_engine.has_value())
+                                return Result::Ok(std::move(maybe_engine.value()));
+                            //otherwise fall back to compiling the engine source
+                        }
+                    }
+
+                    // Get the EngineSource
+                    auto engine_source_r = txn->get_engine_source();
+                    if (!engine_source_r)
+                        return Result::Error(engine_source_r.get_error());
+                    auto engine_source = engine_source_r.unwrap();
+
+                    // Get the WorkerIndex
+                    auto worker_index_r = txn->get_worker_index();
+                    if (!worker_index_r)
+                        return Result::Error(worker_index_r.get_error());
+                    auto worker_index = worker_index_r.unwrap();
+
+                    // Get the code caches of the modules
+                    ModuleCodeCaches code_caches{};
+                    if (use_code_cache) {
+                        std::vector<u16> file_ids{ESTATE_FACTORY_MODULE_CODE_CACHE_ID};
+                        if (worker_index->file_names()) {
+                            for (const auto f: *worker_index->file_names())
+                                file_ids.push_back(f->file_name_id());
+                        }
+                        for (const auto file_id: file_ids) {
+                            auto code_cache_r = txn->maybe_get_code_cache(file_id);
+                            if (!code_cache_r)
+                                return Result::Error(code_cache_r.get_error());
+                            auto maybe_code_cache = code_cache_r.unwrap();
+                            if (maybe_code_cache.has_value())
+                                code_caches.existing.emplace(file_id, std::move(maybe_code_cache.value()));
+                        }
+                    }
+
+                    // Create the Engine
+                    auto engine_r = EngineFactory::CreateEngine(log_context,
+                                                                std::move(worker_index),
+                                                                std::move(engine_source),
+                                                                this->_max_heap_size,
+                                                                use_code_cache ? &code_caches : nullptr);
+                    if (!engine_r)
+                        return Result::Error(engine_r.get_error());
+
+                    // Replace the code caches that were missing or that V8 rejected
+                    for (const auto &[file_id, code_cache]: code_caches.created) {
+                        //a failed refresh is already logged and only costs a recompile next time
+                        const auto unused = txn->refresh_code_cache(file_id, code_cache);
+                    }
+
+                    return Result::Ok(std::move(engine_r.unwrap()));
+                }
                 EngineResultCode<EngineHandle> get_engine(CallContextS call_context) {
                     using OutResult = EngineResultCode<EngineHandle>;
 
@@ -3392,31 +4512,9 @@ namespace estate {
 
                     // Get the Engine
                     auto engine_handle_r = engine_pool->get_resource([this, &log_context, &txn]() {
-                        using Result = EngineResultCode<EngineU>;
-
-                        // Get the EngineSource
-                        auto engine_source_r = txn->get_engine_source();
-                        if (!engine_source_r)
-                            return Result::Error(engine_source_r.get_error());
-                        auto engine_source = engine_source_r.unwrap();
-
-                        // Get the WorkerIndex
-                        auto worker_index_r = txn->get_worker_index();
-                        if (!worker_index_r)
-                            return Result::Error(worker_index_r.get_error());
-                        auto worker_index = worker_index_r.unwrap();
-
-                        // Create the Engine
-                        auto engine_r = EngineFactory::CreateEngine(log_context,
-                                                                    std::move(worker_index),
-                                                                    std::move(engine_source),
-                                                                    this->_max_heap_size);
-                        if (!engine_r)
-                            return Result::Error(engine_r.get_error());
-
-                        return Result::Ok(std::move(engine_r.unwrap()));
+                        return create_engine(log_context, txn);
                     }, [&worker_version](EngineU &engine) {
-                        return engine->worker_version() == worker_version;
+                        return engine->worker_version() == worker_version && !engine->is_terminated();
                     });
 
                     if (!engine_handle_r) {
@@ -3431,113 +4529,54 @@ namespace estate {
 
                     return OutResult::Ok(std::move(engine_handle));
                 }
-                ResultCode<std::pair<v8::Local<v8::String>, std::string_view>> get_service_method_name(const LogContext &log_context,
-                                                                                                       v8::Isolate *isolate_,
-                                                                                                       const WorkerIndexProto &worker_index,
-                                                                                                       ClassId class_id,
-                                                                                                       MethodId method_id) {
-                    using Result = ResultCode<std::pair<v8::Local<v8::String>, std::string_view>>;
+                ResultCode<std::pair<v8::Local<v8::Function>, std::string_view>> get_service_method(const LogContext &log_context,
+                                                                                                    v8::Isolate *isolate_,
+                                                                                                    const Engine &engine,
+                                                                                                    ClassId class_id,
+                                                                                                    MethodId method_id) {
+                    using Result = ResultCode<std::pair<v8::Local<v8::Function>, std::string_view>>;
 
                     V8_ESCAPABLE_SCOPE(isolate_);
 
-                    if (!worker_index.service_classes())
+                    const auto *method = engine.maybe_get_service_method(class_id, method_id);
+                    if (!method) {
+                        log_error(log_context, "Unable to get the service method because the class {} wasn't found", class_id);
                         return Result::Error(Code::ScriptEngine_ClassNotFound);
-
-                    for (int i = 0; i < worker_index.service_classes()->size(); ++i) {
-                        auto cls = worker_index.service_classes()->Get(i);
-                        if (cls->class_id() != class_id)
-                            continue;
-                        if (!cls->methods()) {
-                            log_error(log_context, "Unable to get the service method name because the specified class {} had no methods", class_id);
-                            return Result::Error(Code::ScriptEngine_MethodNotFound);
-                        }
-                        for (int j = 0; j < cls->methods()->size(); ++j) {
-                            auto method = cls->methods()->Get(j);
-                            if (method->method_id() == method_id) {
-                                auto method_name_view = method->method_name()->string_view();
-                                auto method_name = V8_STRING(method_name_view.data(), method_name_view.size());
-                                return Result::Ok(std::make_pair(handle_scope.Escape(method_name), method_name_view));
-                            }
-                        }
-                        log_error(log_context, "Unable to get the service method name because the method {} wasn't found on the class {}", method_id,
+                    }
+                    if (method->method_name.empty()) {
+                        log_error(log_context, "Unable to get the service method because the method {} wasn't found on the class {}", method_id,
                                   class_id);
                         return Result::Error(Code::ScriptEngine_MethodNotFound);
                     }
-
-                    log_error(log_context, "Unable to get the service method name because the class {} wasn't found", class_id);
-                    return Result::Error(Code::ScriptEngine_ClassNotFound);
-                }
-                ResultCode<v8::Local<v8::Function>>
-                get_service_method(const LogContext &log_context, v8::Isolate *isolate_, v8::Local<v8::Object> &service,
-                                   v8::Local<v8::String> &method_name) {
-                    using Result = ResultCode<v8::Local<v8::Function>>;
-
-                    V8_ESCAPABLE_SCOPE(isolate_);
-
-                    v8::Local<v8::Object> service_proto = v8::Local<v8::Object>::Cast(service->GetPrototype());
-
-                    v8::Local<v8::Value> method_val;
-                    if (!service_proto->Get(context, method_name).ToLocal(&method_val)) {
-                        log_error(log_context, "Unable to get the service method off the service prototype");
-                        return Result::Error(Code::ScriptEngine_UnableToGetMethod);
-                    }
-
-                    if (!method_val->IsFunction()) {
-                        log_error(log_context, "Unable to get the service method because it wasn't a function");
-                        return Result::Error(Code::ScriptEngine_UnableToGetMethodBecauseItWasNotAFunction);
+                    if (method->function.IsEmpty()) {
+                        log_error(log_context, "Unable to get the service method {} off the service prototype: {}", method->method_name,
+                                  get_code_name(method->error));
+                        return Result::Error(method->error);
                     }
 
-                    const auto method = v8::Local<v8::Function>::Cast(method_val);
-
-                    return Result::Ok(handle_scope.Escape(method));
+                    return Result::Ok(std::make_pair(handle_scope.Escape(method->function.Get(isolate)), method->method_name));
                 }
-            public:
+                // Loads the service, calls the method and makes the response, everything in a request that can run user code.
                 EngineResultCode<CallServiceMethodResult>
-                call_service_method(CallContextS call_context, const CallServiceMethodRequestProto *request) override {
+                call_service_method_in_engine(CallContextS call_context, const CallServiceMethodRequestProto *request, EngineHandle &engine,
+                                              v8::Isolate *isolate, v8::Local<v8::Context> context) {
                     using Result = EngineResultCode<CallServiceMethodResult>;
                     const auto &log_context = call_context->get_log_context();
-                    Stopwatch timing_overall{log_context};
-
-                    Stopwatch timing_delta_application{log_context};
                     auto txn = call_context->get_transaction();
                     auto working_set = call_context->get_working_set();
 
-                    // Apply in-memory changes to any Data the arguments reference
-                    if (request->referenced_data_deltas() && request->referenced_data_deltas()->size()) {
-                        for (auto i = 0; i < request->referenced_data_deltas()->size(); ++i) {
-                            const auto *delta = request->referenced_data_deltas()->Get(i);
-                            WORKED_OR_RETURN(data::apply_inbound_delta(*call_context->get_reusable_builder(true),
-                                                                       *delta,
-                                                                       working_set,
-                                                                       call_context->get_buffer_pool(),
-                                                                       false));
-                        }
-                    }
-                    timing_delta_application.log_elapsed("Delta Application");
-
-                    // Get the engine
-                    Stopwatch timing_get_engine{log_context};
-                    UNWRAP_OR_RETURN(engine, get_engine(call_context));
-                    timing_get_engine.log_elapsed("Get engine");
-
-                    Stopwatch setup_isolate_context{log_context};
-                    V8_SCOPE_INHERIT_CONTEXT(engine.get()->isolate(), engine.get()->parent_context());
-                    set_stack_limit(isolate);
-                    setup_isolate_context.log_elapsed("Setup isolate and context");
-
                     Stopwatch timing_js_service_object{log_context};
 
                     // Set the isolate so WorkingSet/Object/Property etc. can access it.
                     call_context->set_isolate(isolate);
 
                     const auto class_id = request->class_id();
-                    const auto &worker_index = engine.get()->get_worker_index();
                     const auto method_id = request->method_id();
 
-                    auto method_name_pair_r = get_service_method_name(log_context, isolate, worker_index, class_id, method_id);
-                    if (!method_name_pair_r)
-                        return Result::Error(method_name_pair_r.get_error());
-                    auto[method_name, method_name_view] = method_name_pair_r.unwrap();
+                    auto method_r = get_service_method(log_context, isolate, *engine.get(), class_id, method_id);
+                    if (!method_r)
+                        return Result::Error(method_r.get_error());
+                    auto[method, method_name_view] = method_r.unwrap();
 
                     // Get the service object and its prototype so we can call the method on it
                     UNWRAP_OR_RETURN(service, js_load_object<data::ObjectType::WORKER_SERVICE>(isolate,
@@ -3548,8 +4587,6 @@ namespace estate {
 
                     timing_js_service_object.log_elapsed("Load Service Object");
 
-                    UNWRAP_OR_RETURN(method, get_service_method(log_context, isolate, service, method_name));
-
                     Stopwatch timing_deserialize_arguments{log_context};
 
                     // Deserialize the arguments
@@ -3611,26 +4648,104 @@ namespace estate {
                     UNWRAP_OR_RETURN(response_buffer, make_call_service_method_response(isolate, call_context, result_val, data_saved));
                     timing_make_response.log_elapsed("Make Response");
 
-                    timing_overall.log_elapsed("Overall");
-
                     return Result::Ok(CallServiceMethodResult{
                             services_saved || data_saved,
                             std::move(response_buffer)
                     });
                 }
-                JsObjectRuntime(size_t max_heap_size) :
-                        _max_heap_size{max_heap_size} {}
+            public:
+                EngineResultCode<CallServiceMethodResult>
+                call_service_method(CallContextS call_context, const CallServiceMethodRequestProto *request) override {
+                    using Result = EngineResultCode<CallServiceMethodResult>;
+                    const auto &log_context = call_context->get_log_context();
+                    Stopwatch timing_overall{log_context};
+
+                    Stopwatch timing_delta_application{log_context};
+                    auto working_set = call_context->get_working_set();
+
+                    // Apply in-memory changes to any Data the arguments reference
+                    if (request->referenced_data_deltas() && request->referenced_data_deltas()->size()) {
+                        for (auto i = 0; i < request->referenced_data_deltas()->size(); ++i) {
+                            const auto *delta = request->referenced_data_deltas()->Get(i);
+                            WORKED_OR_RETURN(data::apply_inbound_delta(*call_context->get_reusable_builder(true),
+                                                                       *delta,
+                                                                       working_set,
+                                                                       call_context->get_buffer_pool(),
+                                                                       false));
+                        }
+                    }
+                    timing_delta_application.log_elapsed("Delta Application");
+
+                    // Get the engine
+                    Stopwatch timing_get_engine{log_context};
+                    UNWRAP_OR_RETURN(engine, get_engine(call_context));
+                    timing_get_engine.log_elapsed("Get engine");
+
+                    Stopwatch setup_isolate_context{log_context};
+                    V8_SCOPE_INHERIT_CONTEXT(engine.get()->isolate(), engine.get()->parent_context());
+                    set_stack_limit(isolate);
+                    setup_isolate_context.log_elapsed("Setup isolate and context");
+
+                    // Watch everything that can run user code, the constructors, getters and method alike
+                    auto maybe_watch = execution_watchdog ? execution_watchdog->watch(isolate) : nullptr;
+                    auto result = call_service_method_in_engine(call_context, request, engine, isolate, context);
+                    if (maybe_watch && maybe_watch->release()) {
+                        engine.get()->set_terminated();
+                        log_warn(log_context, "The call to service method {} was terminated because it exceeded its execution time limit",
+                                 request->method_id());
+                        return Result::Error(Code::ScriptEngine_ExecutionTimeout);
+                    }
+
+                    timing_overall.log_elapsed("Overall");
+
+                    return std::move(result);
+                }
+                EngineResultCode<bool> warm_engine(const LogContext &log_context, storage::ITransactionS txn) override {
+                    using Result = EngineResultCode<bool>;
+                    auto engine_pool = get_engine_pool(txn->get_worker_id());
+                    if (engine_pool->is_full())
+                        return Result::Ok(false);
+                    UNWRAP_OR_RETURN(engine, create_engine(log_context, txn));
+                    return Result::Ok(engine_pool->add_resource(std::move(engine)));
+                }
+                void evict_idle_engines() override {
+                    std::vector<EnginePoolS> engine_pools{};
+                    {
+                        std::lock_guard<std::mutex> lck(_worker_id_engine_pool_mutex);
+                        for (const auto &[_, engine_pool]: _worker_id_engine_pool)
+                            engine_pools.push_back(engine_pool);
+                    }
+                    for (auto &engine_pool: engine_pools)
+                        engine_pool->evict_idle();
+                }
+                size_t get_peak_engine_count(const WorkerId worker_id) override {
+                    return get_engine_pool(worker_id)->peak_outstanding_lease_count();
+                }
+                JsObjectRuntime(size_t max_heap_size, PoolConfig engine_pool_config) :
+                        _max_heap_size{max_heap_size}, _engine_pool_config{engine_pool_config} {}
             };
-            IObjectRuntimeS create_object_runtime(size_t max_heap_size) {
-                return std::make_shared<JsObjectRuntime>(max_heap_size);
+            IObjectRuntimeS create_object_runtime(size_t max_heap_size, PoolConfig engine_pool_config) {
+                return std::make_shared<JsObjectRuntime>(max_heap_size, engine_pool_config);
             }
             class JsSetupRuntime : public virtual ISetupRuntime {
+                size_t _max_heap_size;
             public:
+                explicit JsSetupRuntime(size_t max_heap_size) : _max_heap_size(max_heap_size) {}
                 UnitEngineResultCode
                 setup(const LogContext &log_context, storage::ITransactionS txn, const SetupWorkerRequestProto *request, bool is_new) override {
                     using Result = UnitEngineResultCode;
 
                     if (!is_new) {
+                        //Delete the previous code caches, this has to happen while the transaction is still at the previous worker version
+                        {
+                            UNWRAP_OR_RETURN(previous_worker_index, txn->get_worker_index());
+                            WORKED_OR_RETURN(txn->delete_code_cache(ESTATE_FACTORY_MODULE_CODE_CACHE_ID));
+                            if (previous_worker_index->file_names()) {
+                                for (const auto f: *previous_worker_index->file_names())
+                                    WORKED_OR_RETURN(txn->delete_code_cache(f->file_name_id()));
+                            }
+                            log_trace(log_context, "Deleted the previous code caches for worker version {}", request->previous_worker_version());
+                        }
                         /*NOTE: I'm not sure deletes are strictly needed but I like the idea of locking their fields early in the transaction.*/
                         //Delete the previous worker index
                         WORKED_OR_RETURN(txn->delete_worker_index());
@@ -3638,6 +4753,9 @@ namespace estate {
                         //Delete the previous engine source
                         WORKED_OR_RETURN(txn->delete_engine_source());
                         log_trace(log_context, "Deleted the previous engine source for worker version {}", request->previous_worker_version());
+                        //Delete the previous engine snapshot
+                        WORKED_OR_RETURN(txn->delete_engine_snapshot());
+                        log_trace(log_context, "Deleted the previous engine snapshot for worker version {}", request->previous_worker_version());
                     }
 
                     flatbuffers::FlatBufferBuilder builder{};
@@ -3655,22 +4773,51 @@ namespace estate {
                     WORKED_OR_RETURN(txn->save_engine_source(BufferView<EngineSourceProto>{builder}));
                     log_trace(log_context, "Saved the engine source for worker version {}", request->worker_version());
 
+                    //Save the engine snapshot, experimental because V8 aborts on heaps it can't serialize
+                    if (use_snapshots) {
+                        auto maybe_snapshot = EngineFactory::CreateSnapshot(log_context,
+                                                                            BufferView<WorkerIndexProto>{*request->worker_index()},
+                                                                            BufferView<EngineSourceProto>{builder});
+                        if (maybe_snapshot.has_value()) {
+                            WORKED_OR_RETURN(txn->save_engine_snapshot(maybe_snapshot.value()));
+                            log_trace(log_context, "Saved the engine snapshot for worker version {}", request->worker_version());
+                        }
+                    }
+
                     //Save the worker index
                     WORKED_OR_RETURN(txn->save_worker_index(request->worker_version(),
                                                           BufferView<WorkerIndexProto>{request->worker_index()->data(), request->worker_index()->size()}));
                     log_trace(log_context, "Saved the new worker index for worker version {}", request->worker_version());
 
+                    //Save the code caches, now that the transaction is at the new worker version
+                    if (use_code_cache) {
+                        const auto code_caches = EngineFactory::CreateCodeCaches(log_context,
+                                                                                 BufferView<WorkerIndexProto>{*request->worker_index()},
+                                                                                 BufferView<EngineSourceProto>{builder},
+                                                                                 _max_heap_size);
+                        for (const auto &[file_id, code_cache]: code_caches)
+                            WORKED_OR_RETURN(txn->save_code_cache(file_id, code_cache));
+                        log_trace(log_context, "Saved {} code caches for worker version {}", code_caches.size(), request->worker_version());
+                    }
+
                     return Result::Ok();
                 }
             };
-            ISetupRuntimeS create_setup_runtime() {
-                return std::make_shared<JsSetupRuntime>();
+            ISetupRuntimeS create_setup_runtime(size_t max_heap_size) {
+                return std::make_shared<JsSetupRuntime>(max_heap_size);
             }
             static std::unique_ptr<v8::Platform> platform{};
             bool is_initialized() {
                 return platform != nullptr;
             }
             void initialize(const JavascriptConfig &config) {
+                use_snapshots = config.experimental_use_snapshots;
+                use_code_cache = config.use_code_cache;
+                if (config.max_call_wall_ms > 0 || config.max_call_cpu_ms > 0) {
+                    execution_watchdog = std::make_unique<ExecutionWatchdog>(config.max_call_wall_ms,
+                                                                             config.max_call_cpu_ms,
+                                                                             config.execution_check_interval_ms);
+                }
                 v8::V8::InitializeICUDefaultLocation(config.icu_location.c_str());
                 v8::V8::InitializeExternalStartupData(config.external_startup_data.c_str());
                 platform = v8::platform::NewDefaultPlatform();
@@ -3679,6 +4826,7 @@ namespace estate {
             }
             void shutdown() {
                 assert(platform);
+                execution_watchdog = nullptr;
                 v8::V8::ShutdownPlatform();
                 platform = nullptr;
             }
@@ -4768,7 +5916,55 @@ namespace estate {
                 }
                 namespace object {
                     namespace detail {
-                        static const std::string PRIMARY_KEY_PROPERTY_NAME{"primaryKey"};
+                        // The UTF-8 of a property name, in a stack buffer unless it's too long to fit.
+                        class PropertyName {
+                            char _buffer[ESTATE_PROPERTY_NAME_BUFFER_SIZE];
+                            std::optional<v8::String::Utf8Value> _maybe_long{};
+                            std::string_view _view{};
+                        public:
+                            PropertyName(v8::Isolate *isolate, v8::Local<v8::Name> name) {
+                                assert(name->IsString());
+                                const auto str = name.As<v8::String>();
+                                int chars{0};
+                                const auto size = str->WriteUtf8(isolate, _buffer, sizeof(_buffer), &chars, v8::String::NO_NULL_TERMINATION);
+                                if (chars == str->Length()) {
+                                    _view = std::string_view{_buffer, static_cast<size_t>(size)};
+                                } else {
+                                    _maybe_long.emplace(isolate, name);
+                                    _view = std::string_view{**_maybe_long, static_cast<size_t>(_maybe_long->length())};
+                                }
+                            }
+                            PropertyName(const PropertyName &) = delete;
+                            [[nodiscard]] std::string_view view() const {
+                                return _view;
+                            }
+                        };
+
+                        /* The member's cached function when the object's prototype is the one it was resolved against,
+                         * otherwise it's looked up off the object's prototype like a derived class would need. */
+                        v8::MaybeLocal<v8::Function> get_member_function(v8::Isolate *isolate, v8::Local<v8::Context> context,
+                                                                         const Engine &engine, ClassId class_id,
+                                                                         v8::Local<v8::Object> object, v8::Local<v8::Name> name,
+                                                                         const v8::Global<v8::Function> &cached, const char *accessor) {
+                            const auto object_proto_val = object->GetPrototype();
+                            if (!cached.IsEmpty() && object_proto_val == engine.maybe_get_prototype(class_id))
+                                return cached.Get(isolate);
+                            v8::Local<v8::Object> object_proto;
+                            if (!object_proto_val->ToObject(context).ToLocal(&object_proto))
+                                return {};
+                            v8::Local<v8::Value> value;
+                            if (!accessor) {
+                                if (!object_proto->Get(context, name).ToLocal(&value) || !value->IsFunction())
+                                    return {};
+                                return value.As<v8::Function>();
+                            }
+                            v8::Local<v8::Value> descriptor;
+                            if (!object_proto->GetOwnPropertyDescriptor(context, name).ToLocal(&descriptor) || !descriptor->IsObject() ||
+                                !descriptor.As<v8::Object>()->Get(context, V8_STRING(accessor, -1)).ToLocal(&value) ||
+                                !value->IsFunction())
+                                return {};
+                            return value.As<v8::Function>();
+                        }
 
                         template<data::ObjectType>
                         void on_property_get(const char *from, v8::Local<v8::Name> name, const v8::PropertyCallbackInfo<v8::Value> &info) {
@@ -4780,54 +5976,45 @@ namespace estate {
                             auto call_context = engine->get_call_context();
                             const auto &log_context = call_context->get_log_context();
 
-                            //convert the name to a string I can use
-                            v8::String::Utf8Value name_val_str(isolate, name);
-                            const std::string name_str{*name_val_str, static_cast<size_t>(name_val_str.length())};
-
                             if (name->IsSymbol()) {
-                                log_warn(log_context, "Name {0} is a Symbol, skipping read operation", name_str);
+                                v8::String::Utf8Value name_val_str(isolate, name);
+                                log_warn(log_context, "Name {0} is a Symbol, skipping read operation", *name_val_str);
                                 return;
                             }
 
                             const auto ref = object->get_reference();
 
                             //if they're asking for the primary key, return that.
-                            if (name_str == PRIMARY_KEY_PROPERTY_NAME) {
+                            if (engine->is_primary_key_name(name)) {
                                 const auto pk = ref->get_primary_key().view();
                                 info.GetReturnValue().Set(handle_scope.Escape(V8_STRING(pk.data(), pk.size())));
                                 return;
                             }
 
-                            std::optional<MethodKindProto> method_kind;
-                            if (ref->is_data()) {
-                                method_kind = engine->object_has_getter_or_normal_method(ref->class_id, name_str);
-                            } else {
-                                if (engine->service_has_method(ref->class_id, name_str))
-                                    method_kind = MethodKindProto::Normal;
-                            }
-
-                            if (method_kind) {
-                                auto object_proto = info.This()->GetPrototype()->ToObject(context).ToLocalChecked();
-                                if (method_kind.value() == MethodKindProto::Getter) {
-                                    //Get the getter function and call it
-                                    v8::Local<v8::Object> method_descriptor = v8::Local<v8::Object>::Cast(
-                                            object_proto->GetOwnPropertyDescriptor(context, name).ToLocalChecked());
-                                    static const std::string GET{"get"};
-                                    v8::Local<v8::Value> get_val = v8::String::NewFromUtf8(isolate, GET.data(), v8::NewStringType::kNormal,
-                                                                                           GET.size()).ToLocalChecked();
-                                    auto get_method = v8::Local<v8::Function>::Cast(method_descriptor->Get(context, get_val).ToLocalChecked());
-                                    auto value = get_method->CallAsFunction(context, info.This(), 0, nullptr).ToLocalChecked();
-                                    info.GetReturnValue().Set(value);
+                            const auto *member = engine->maybe_get_class_member(ref->class_id, name);
+                            if (member && (member->is_getter || member->is_method)) {
+                                const auto *accessor = member->is_getter ? "get" : nullptr;
+                                const auto &cached = member->is_getter ? member->getter : member->method;
+                                v8::Local<v8::Function> function;
+                                if (!get_member_function(isolate, context, *engine, ref->class_id, info.This(), name, cached, accessor)
+                                        .ToLocal(&function)) {
+                                    V8_THROW(from, "Unable to get the class method");
+                                    log_error(log_context, "Failure in {}: {}", __PRETTY_FUNCTION__, error_message);
                                     return;
-                                } else if (method_kind.value() == MethodKindProto::Normal) {
-                                    auto method = v8::Local<v8::Function>::Cast(object_proto->Get(context, name).ToLocalChecked());
-                                    info.GetReturnValue().Set(method);
+                                }
+                                if (member->is_getter) {
+                                    //Call the getter
+                                    v8::Local<v8::Value> value;
+                                    if (function->Call(context, info.This(), 0, nullptr).ToLocal(&value))
+                                        info.GetReturnValue().Set(value);
                                     return;
                                 }
-                                assert(false);
+                                info.GetReturnValue().Set(function);
+                                return;
                             }
 
-                            auto prop_r = object->get_property(name_str);
+                            const PropertyName property_name{isolate, name};
+                            auto prop_r = object->get_property(property_name.view());
                             if (!prop_r) {
                                 V8_THROW(from, "Unable to get property when trying to read it");
                                 log_error(log_context, "Failure in {} '{}' code: {}", __PRETTY_FUNCTION__, error_message,
@@ -4875,46 +6062,47 @@ namespace estate {
                             auto call_context = engine->get_call_context();
                             const auto &log_context = call_context->get_log_context();
 
-                            v8::String::Utf8Value name_val_str(isolate, name);
-                            std::string name_str{*name_val_str, static_cast<size_t>(name_val_str.length())};
-
                             if (name->IsSymbol()) {
-                                log_error(log_context, "Name {0} is a Symbol, skipping read operation", name_str);
+                                v8::String::Utf8Value name_val_str(isolate, name);
+                                log_error(log_context, "Name {0} is a Symbol, skipping read operation", *name_val_str);
                                 return;
                             }
 
-                            if (name_str == PRIMARY_KEY_PROPERTY_NAME) {
+                            if (engine->is_primary_key_name(name)) {
                                 V8_THROW(from, "Cannot change an object's primary key.");
                                 log_warn(log_context, "Failure in {}: {}", __PRETTY_FUNCTION__, error_message);
                                 return;
                             }
 
                             const auto ref = object->get_reference();
+                            const auto *member = engine->maybe_get_class_member(ref->class_id, name);
 
                             if (ref->is_data()) {
-                                if (engine->object_has_setter_method(ref->class_id, name_str)) {
-                                    //Get the setter function and call it
-                                    auto object_proto = info.This()->GetPrototype()->ToObject(context).ToLocalChecked();
-                                    v8::Local<v8::Object> method_descriptor = v8::Local<v8::Object>::Cast(
-                                            object_proto->GetOwnPropertyDescriptor(context, name).ToLocalChecked());
-                                    static const std::string SET{"set"};
-                                    v8::Local<v8::Value> set_str = v8::String::NewFromUtf8(isolate, SET.data(), v8::NewStringType::kNormal,
-                                                                                           SET.size()).ToLocalChecked();
-                                    auto set_method = v8::Local<v8::Function>::Cast(method_descriptor->Get(context, set_str).ToLocalChecked());
-                                    set_method->Call(context, info.This(), 1, &value).ToLocalChecked();
-                                    info.GetReturnValue().Set(false);
+                                if (member && member->is_setter) {
+                                    //Call the setter
+                                    v8::Local<v8::Function> set_method;
+                                    if (!get_member_function(isolate, context, *engine, ref->class_id, info.This(), name, member->setter, "set")
+                                            .ToLocal(&set_method)) {
+                                        V8_THROW(from, "Unable to get the class setter");
+                                        log_error(log_context, "Failure in {}: {}", __PRETTY_FUNCTION__, error_message);
+                                        return;
+                                    }
+                                    v8::Local<v8::Value> unused;
+                                    if (set_method->Call(context, info.This(), 1, &value).ToLocal(&unused))
+                                        info.GetReturnValue().Set(false);
                                     return;
                                 }
                             } else {
                                 assert(ref->is_service());
-                                if (engine->service_has_method(ref->class_id, name_str)) {
+                                if (member) {
                                     V8_THROW(from, "Cannot set worker class function values at runtime");
                                     log_warn(log_context, "Failure in {}: {}", __PRETTY_FUNCTION__, error_message);
                                     return;
                                 }
                             }
 
-                            auto prop_r = object->get_property(name_str);
+                            const PropertyName property_name{isolate, name};
+                            auto prop_r = object->get_property(property_name.view());
                             if (!prop_r) {
                                 V8_THROW(from, "Unable to get property when trying to set it");
                                 log_error(log_context, "Failure in {} '{}' code: {}", __PRETTY_FUNCTION__, error_message,
@@ -4939,10 +6127,7 @@ namespace estate {
                                 return;
                             }
 
-                            v8::String::Utf8Value name_value_str(isolate, name);
-                            std::string name_str{*name_value_str, static_cast<size_t>(name_value_str.length())};
-
-                            if (name_str == PRIMARY_KEY_PROPERTY_NAME) {
+                            if (engine->is_primary_key_name(name)) {
                                 V8_THROW(from, "Cannot delete an object's primary key.");
                                 log_warn(log_context, "Failure in {}: {}", __PRETTY_FUNCTION__, error_message);
                                 return;
@@ -4950,21 +6135,14 @@ namespace estate {
 
                             const auto &ref = object->get_reference();
 
-                            bool has_method = false;
-                            if (ref->is_data()) {
-                                has_method = engine->object_has_method(ref->class_id, name_str);
-                            } else {
-                                assert(ref->is_service());
-                                has_method = engine->service_has_method(ref->class_id, name_str);
-                            }
-
-                            if (has_method) {
+                            if (engine->maybe_get_class_member(ref->class_id, name)) {
                                 V8_THROW(from, "Cannot delete worker class methods at runtime");
                                 log_error(log_context, "Failure in {}: {}", __PRETTY_FUNCTION__, error_message);
                                 return;
                             }
 
-                            auto prop_r = object->get_property(name_str);
+                            const PropertyName property_name{isolate, name};
+                            auto prop_r = object->get_property(property_name.view());
                             if (!prop_r) {
                                 V8_THROW(from, "Unable to get property while trying to delete it");
                                 log_error(log_context, "Failure in {} '{}' code: {}", __PRETTY_FUNCTION__, error_message,
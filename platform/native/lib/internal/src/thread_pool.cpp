@@ -25,6 +25,10 @@ namespace estate {
         context->stop();
     }
 
+    void ThreadPool::join() {
+        thread_group.join_all();
+    }
+
     bool ThreadPool::is_started() const {
         return keep_running_work != nullptr;
     }
@@ -15,11 +15,16 @@ namespace estate {
     struct RiverProcessorConfig {
         size_t min_primary_key_length;
         size_t max_primary_key_length;
+        //how long to wait on a worker process before responding with Innerspace_RequestTimeout. Unset waits until the connection faults.
+        std::optional<std::chrono::milliseconds> worker_request_timeout;
 
         static RiverProcessorConfig FromRemote(const LocalConfigurationReader &reader) {
+            auto worker_request_timeout_ms = reader.try_get_u32("worker_request_timeout_ms");
             return RiverProcessorConfig{
                     reader.get_u64("min_primary_key_length"),
                     reader.get_u64("max_primary_key_length"),
+                    worker_request_timeout_ms.has_value() && worker_request_timeout_ms.value() > 0 ?
+                    std::optional<std::chrono::milliseconds>{worker_request_timeout_ms.value()} : std::nullopt
             };
         }
     };
@@ -44,7 +49,9 @@ namespace estate {
     void execute(const RiverProcessorConfig &config,
                  RiverServiceProviderS service_provider,
                  Buffer<UserRequestProto> &&request_buffer,
-                 RequestContextS request_context);
+                 RequestContextS request_context,
+                 WorkQueue &,
+                 NoExecutorStats &);
 
     using RiverProcessor = Processor<
             RiverProcessorConfig,
@@ -53,5 +60,6 @@ namespace estate {
             RiverServiceProvider,
             outerspace::RequestContext,
             Buffer<UserRequestProto>,
+            NoExecutorStats,
             execute>;
 }
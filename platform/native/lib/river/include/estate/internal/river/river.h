@@ -24,13 +24,14 @@ namespace estate {
         template<typename... SPArgs>
         void init(const ProcessorConfig &processor_config,
                   const outerspace::Config &outerspace_config,
+                  const WorkQueueConfig &work_queue_config,
                   BufferPoolS buffer_pool,
                   ThreadPoolS thread_pool,
                   WorkerAuthenticationS worker_authentication,
                   SPArgs... spargs) {
             assert(!has_init);
             service_provider = std::make_shared<ServiceProvider>(std::forward<SPArgs>(spargs)...);
-            processor = std::make_shared<TProcessor>(processor_config, service_provider);
+            processor = std::make_shared<TProcessor>(processor_config, service_provider, work_queue_config);
             outerspace_server = outerspace::create_server(outerspace_config, worker_authentication, thread_pool->get_context(), buffer_pool,
                                                [p{processor}](outerspace::WebSocketSessionS websocket_session, WorkerId authorized_worker_id, RequestId request_id, Buffer<UserRequestProto> &&request_buffer) mutable {
                                                    auto request_context = std::make_shared<outerspace::RequestContext>(websocket_session, authorized_worker_id, request_id);
@@ -41,6 +42,12 @@ namespace estate {
         void start() {
             outerspace_server->start();
         }
+        void shutdown() {
+            processor->shutdown();
+        }
+        [[nodiscard]] auto get_stats() const {
+            return processor->get_stats();
+        }
     private:
         std::shared_ptr<ServiceProvider> service_provider{};
         std::shared_ptr<TProcessor> processor{};
@@ -57,6 +64,8 @@ namespace estate {
             outerspace::Config outerspace_config{};
             innerspace::InnerspaceClientConfig::AsWorkerUser innerspace_client_config{};
             innerspace::InnerspaceWorkerLoaderClientConfig innerspace_worker_loader_client_config{};
+            WorkQueueConfig work_queue_config{};
+            u32 connection_state_log_interval_ms{0};
         };
         bool has_init{false};
 
@@ -66,6 +75,7 @@ namespace estate {
         WorkerAuthenticationS worker_authentication;
         innerspace::InnerspaceClientS innerspace_client;
         std::atomic_bool keep_running_daemon;
+        std::optional<boost::asio::steady_timer> connection_state_log_timer{};
 
         RiverSystem<RiverProcessor> river_system;
 
@@ -73,5 +83,7 @@ namespace estate {
         void shutdown();
         void init(const Config &config);
         void run(bool daemon);
+    private:
+        void schedule_connection_state_log(std::chrono::milliseconds interval);
     };
 }
@@ -381,26 +381,25 @@ namespace estate {
     }
 
     inline auto create_error(RiverServiceProviderS service_provider, Code code) {
-        fbs::Builder outer_builder{};
-        fbs::Builder inner_builder{};
+        PooledBuilder outer_builder{service_provider->get_buffer_pool()};
+        PooledBuilder inner_builder{service_provider->get_buffer_pool()};
         inner_builder.Finish(CreateUserResponseUnionWrapperProto(inner_builder,
                                                                  UserResponseUnionProto::ErrorCodeResponseProto,
                                                                  CreateErrorCodeResponseProto(inner_builder,
                                                                                               (u16) code).Union()));
-        return finish_and_copy_to_buffer(outer_builder,
-                                         service_provider->get_buffer_pool(),
-                                         CreateRiverUserResponseProto(outer_builder,
-                                                                      CreateUserResponseUnionWrapperBytesProto(outer_builder,
-                                                                                                               outer_builder.CreateVector(
-                                                                                                                       inner_builder.GetBufferPointer(),
-                                                                                                                       inner_builder.GetSize()))));
+        return finish_to_buffer(outer_builder,
+                                CreateRiverUserResponseProto(outer_builder,
+                                                             CreateUserResponseUnionWrapperBytesProto(outer_builder,
+                                                                                                      outer_builder.CreateVector(
+                                                                                                              inner_builder.GetBufferPointer(),
+                                                                                                              inner_builder.GetSize()))));
     }
 
     inline Buffer<RiverUserResponseProto> create_river_user_response(RiverServiceProviderS service_provider,
                                                                      const BufferView<UserResponseUnionWrapperProto> response,
                                                                      std::optional<std::vector<Buffer<UserMessageUnionWrapperProto>>> maybe_messages,
                                                                      std::optional<const BufferView<ConsoleLogProto>> maybe_conlog) {
-        fbs::Builder builder{};
+        PooledBuilder builder{service_provider->get_buffer_pool()};
 
         fbs::Offset<ConsoleLogBytesProto> conlog_off{};
         if (maybe_conlog.has_value()) {
@@ -416,14 +415,13 @@ namespace estate {
             messages_off = builder.CreateVector(message_wrappers);
         }
 
-        return finish_and_copy_to_buffer(builder,
-                                         service_provider->get_buffer_pool(),
-                                         CreateRiverUserResponseProto(builder,
-                                                                      CreateUserResponseUnionWrapperBytesProto(builder,
-                                                                                                               builder.CreateVector(response.as_u8(),
-                                                                                                                                    response.size())),
-                                                                      messages_off,
-                                                                      conlog_off));
+        return finish_to_buffer(builder,
+                                CreateRiverUserResponseProto(builder,
+                                                             CreateUserResponseUnionWrapperBytesProto(builder,
+                                                                                                      builder.CreateVector(response.as_u8(),
+                                                                                                                           response.size())),
+                                                             messages_off,
+                                                             conlog_off));
     }
 
     using MaybeDeltasSent = std::optional<std::unordered_map<outerspace::SessionHandle, std::unordered_set<const DataDeltaBytesProto *>>>;
@@ -532,8 +530,8 @@ namespace estate {
         // Create and send the events
         MaybeRequestorEvents maybe_requestor_events{};
         MaybeDeltasSent maybe_deltas_sent{};
-        fbs::Builder outer_builder{};
-        fbs::Builder inner_builder{};
+        PooledBuilder outer_builder{buffer_pool};
+        PooledBuilder inner_builder{buffer_pool};
         for (const auto[subscriber, event_bytes]: subscriber_events) {
             outer_builder.Reset();
             inner_builder.Reset();
@@ -564,11 +562,10 @@ namespace estate {
                                                                                                          event_bytes->bytes()->size())),
                                                                        delta_bytes_off).Union();
 
-            auto inner_message = finish_and_copy_to_buffer(inner_builder,
-                                                           buffer_pool,
-                                                           CreateUserMessageUnionWrapperProto(inner_builder,
-                                                                                              UserMessageUnionProto::MessageMessageProto,
-                                                                                              event_message_off));
+            auto inner_message = finish_to_buffer(inner_builder,
+                                                  CreateUserMessageUnionWrapperProto(inner_builder,
+                                                                                     UserMessageUnionProto::MessageMessageProto,
+                                                                                     event_message_off));
 
             const auto wrapper_off = CreateUserMessageUnionWrapperBytesProto(outer_builder,
                                                                              outer_builder.CreateVector(inner_message.as_u8(),
@@ -582,13 +579,12 @@ namespace estate {
                 maybe_requestor_events->push_back(std::move(inner_message));
             } else {
                 //broadcast to everyone else
-                const auto message = finish_and_copy_to_buffer(outer_builder,
-                                                               buffer_pool,
-                                                               CreateRiverUserMessageProto(outer_builder,
-                                                                                           outer_builder.CreateString(log_context.get_context()),
-                                                                                           worker_id,
-                                                                                           worker_version,
-                                                                                           wrapper_off));
+                const auto message = finish_to_buffer(outer_builder,
+                                                      CreateRiverUserMessageProto(outer_builder,
+                                                                                  outer_builder.CreateString(log_context.get_context()),
+                                                                                  worker_id,
+                                                                                  worker_version,
+                                                                                  wrapper_off));
                 request_context->async_send_to_session(log_context, subscriber, message.get_view());
             }
         }
@@ -644,8 +640,8 @@ namespace estate {
         }
 
         MaybeRequestorObjectUpdate requestor_object_update{};
-        fbs::Builder inner_builder{};
-        fbs::Builder outer_builder{};
+        PooledBuilder inner_builder{buffer_pool};
+        PooledBuilder outer_builder{buffer_pool};
         for (const auto[subscriber, delta_bytes_list]: subscribers_deltas) {
             inner_builder.Reset();
             outer_builder.Reset();
@@ -657,29 +653,29 @@ namespace estate {
                                                         inner_builder.CreateVector(delta_bytes->bytes()->Data(), delta_bytes->bytes()->size())));
             }
 
-            auto inner_message = finish_and_copy_to_buffer(inner_builder,
-                                                           buffer_pool, CreateUserMessageUnionWrapperProto(inner_builder,
-                                                                                                           UserMessageUnionProto::DataUpdateMessageProto,
-                                                                                                           CreateDataUpdateMessageProto(
-                                                                                                                   inner_builder,
-                                                                                                                   inner_builder.CreateVector(
-                                                                                                                           inner_delta_bytes_vec)).Union()));
+            auto inner_message = finish_to_buffer(inner_builder,
+                                                  CreateUserMessageUnionWrapperProto(inner_builder,
+                                                                                     UserMessageUnionProto::DataUpdateMessageProto,
+                                                                                     CreateDataUpdateMessageProto(
+                                                                                             inner_builder,
+                                                                                             inner_builder.CreateVector(
+                                                                                                     inner_delta_bytes_vec)).Union()));
 
             if (subscriber == requestor) {
                 assert(!requestor_object_update.has_value());
                 requestor_object_update.emplace(std::move(inner_message));
             } else {
-                const auto message = finish_and_copy_to_buffer(outer_builder,
-                                                               buffer_pool, CreateRiverUserMessageProto(outer_builder,
-                                                                                                        outer_builder.CreateString(
-                                                                                                                log_context.get_context()),
-                                                                                                        worker_id,
-                                                                                                        worker_version,
-                                                                                                        CreateUserMessageUnionWrapperBytesProto(
-                                                                                                                outer_builder,
-                                                                                                                outer_builder.CreateVector(
-                                                                                                                        inner_message.as_u8(),
-                                                                                                                        inner_message.size()))));
+                const auto message = finish_to_buffer(outer_builder,
+                                                      CreateRiverUserMessageProto(outer_builder,
+                                                                                  outer_builder.CreateString(
+                                                                                          log_context.get_context()),
+                                                                                  worker_id,
+                                                                                  worker_version,
+                                                                                  CreateUserMessageUnionWrapperBytesProto(
+                                                                                          outer_builder,
+                                                                                          outer_builder.CreateVector(
+                                                                                                  inner_message.as_u8(),
+                                                                                                  inner_message.size()))));
                 request_context->async_send_to_session(log_context, subscriber, message.get_view());
             }
         }
@@ -704,7 +700,6 @@ namespace estate {
                                }
                                auto envelope = envelope_r.unwrap();
                                const auto &response = *envelope.get_payload();
-                               fbs::Builder builder{};
                                auto buffer = create_river_user_response(
                                        service_provider,
                                        BufferView<UserResponseUnionWrapperProto>{*response.response()},
@@ -712,7 +707,7 @@ namespace estate {
                                        std::nullopt
                                );
                                request_context->async_respond(log_context, buffer.get_view());
-                           });
+                           }, config.worker_request_timeout);
     }
 
     void handle_subscribe_data_updates(const RiverProcessorConfig &config, RiverServiceProviderS service_provider,
@@ -736,7 +731,7 @@ namespace estate {
                       session_handle, worker_id, ref->class_id(), ref->primary_key()->string_view());
         }
 
-        fbs::Builder inner_builder{};
+        PooledBuilder inner_builder{service_provider->get_buffer_pool()};
         inner_builder.Finish(CreateUserResponseUnionWrapperProto(inner_builder, UserResponseUnionProto::SubscribeDataUpdatesResponseProto,
                                                                  CreateSubscribeDataUpdatesResponseProto(inner_builder).Union()));
         const auto response = create_river_user_response(
@@ -769,7 +764,7 @@ namespace estate {
                       session_handle, worker_id, ref->class_id(), ref->primary_key()->string_view());
         }
 
-        fbs::Builder inner_builder{};
+        PooledBuilder inner_builder{service_provider->get_buffer_pool()};
         inner_builder.Finish(CreateUserResponseUnionWrapperProto(inner_builder, UserResponseUnionProto::UnsubscribeDataUpdatesResponseProto,
                                                                  CreateUnsubscribeDataUpdatesResponseProto(inner_builder).Union()));
         const auto response = create_river_user_response(
@@ -793,7 +788,7 @@ namespace estate {
 
         subscription_manager->subscribe(worker_id, session_handle, outerspace::MessageSubscription::CreateFrom(request));
 
-        fbs::Builder inner_builder{};
+        PooledBuilder inner_builder{service_provider->get_buffer_pool()};
         inner_builder.Finish(CreateUserResponseUnionWrapperProto(inner_builder, UserResponseUnionProto::SubscribeMessageResponseProto,
                                                                  CreateSubscribeMessageResponseProto(inner_builder).Union()));
         const auto response = create_river_user_response(
@@ -816,7 +811,7 @@ namespace estate {
 
         subscription_manager->unsubscribe(worker_id, session_handle, outerspace::MessageSubscription::CreateFrom(request));
 
-        fbs::Builder inner_builder{};
+        PooledBuilder inner_builder{service_provider->get_buffer_pool()};
         inner_builder.Finish(CreateUserResponseUnionWrapperProto(inner_builder, UserResponseUnionProto::UnsubscribeMessageResponseProto,
                                                                  CreateUnsubscribeMessageResponseProto(inner_builder).Union()));
         const auto response = create_river_user_response(
@@ -875,7 +870,7 @@ namespace estate {
                                    );
                                    request_context->async_respond(log_context, buffer.get_view());
                                }
-                           });
+                           }, config.worker_request_timeout);
     }
 
     void handle_call_service_method(const RiverProcessorConfig &config, RiverServiceProviderS service_provider,
@@ -971,13 +966,15 @@ namespace estate {
                                                                                 maybe_conlog
                                );
                                request_context->async_respond(log_context, response.get_view());
-                           });
+                           }, config.worker_request_timeout);
     }
 
     void execute(const RiverProcessorConfig &config,
                  RiverServiceProviderS service_provider,
                  Buffer<UserRequestProto> &&request_buffer,
-                 RequestContextS request_context) {
+                 RequestContextS request_context,
+                 WorkQueue &,
+                 NoExecutorStats &) {
 
         if (!validate_flatbuffer<UserRequestProto>(request_buffer)) {
             RESPOND_SYS_ERROR(Code::Validator_InvalidFlatbuffer);
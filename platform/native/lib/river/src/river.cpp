@@ -22,7 +22,9 @@ namespace estate {
                 RiverProcessorConfig::FromRemote(local_configuration.create_reader("Processor")),
                 outerspace::Config::FromRemote(local_configuration.create_reader("Outerspace")),
                 innerspace::InnerspaceClientConfig::AsWorkerUser::FromRemote(local_configuration.create_reader("InnerspaceClient")),
-                innerspace::InnerspaceWorkerLoaderClientConfig::FromRemote(local_configuration.create_reader("InnerspaceWorkerLoader"))
+                innerspace::InnerspaceWorkerLoaderClientConfig::FromRemote(local_configuration.create_reader("InnerspaceWorkerLoader")),
+                WorkQueueConfig::FromRemote(local_configuration.create_reader("WorkQueue")),
+                local_configuration.create_reader("InnerspaceClient").get_u32("connection_state_log_interval_ms", 0)
         };
     }
     void River::shutdown() {
@@ -31,8 +33,37 @@ namespace estate {
         thread_pool->shutdown();
         thread_pool = nullptr;
 
+        // The pool is stopped, so the log handler can no longer re-arm the timer
+        connection_state_log_timer.reset();
+
+        river_system.shutdown();
+
         sys_log_info("Estate River shut down cleanly");
     }
+    void River::schedule_connection_state_log(const std::chrono::milliseconds interval) {
+        connection_state_log_timer.value().expires_after(interval);
+        connection_state_log_timer.value().async_wait([this, interval](const boost::system::error_code &error) {
+            if (error)
+                return; //cancelled at shutdown
+            for (const auto &state : innerspace_client->get_connection_states()) {
+                sys_log_info("Worker {} connection to {}: {}, breaker {}, {} in flight",
+                             state.worker_id,
+                             state.connection.peer_name,
+                             state.connection.is_connected ? "connected" : "disconnected",
+                             innerspace::get_breaker_state_name(state.connection.breaker_state),
+                             state.connection.in_flight);
+            }
+            const auto work_queue = river_system.get_stats().work_queue;
+            sys_log_info("Work queue: {} waiting, max depth {}, {} executed, {} ran inline, {} waited for their key, max wait {}us",
+                         work_queue.depth,
+                         work_queue.max_depth_seen,
+                         work_queue.executed,
+                         work_queue.ran_inline,
+                         work_queue.ordered_waits,
+                         work_queue.max_wait.count());
+            schedule_connection_state_log(interval);
+        });
+    }
     void River::init(const Config &config) {
         assert(!has_init);
         init_logging(config.logging_config, false);
@@ -53,12 +84,18 @@ namespace estate {
 
         river_system.init(config.processor_config,
                           config.outerspace_config,
+                          config.work_queue_config,
                           buffer_pool,
                           thread_pool,
                           worker_authentication,
                           buffer_pool,
                           subscription_manager,
                           innerspace_client);
+
+        if (config.connection_state_log_interval_ms > 0) {
+            connection_state_log_timer.emplace(*thread_pool->get_context());
+            schedule_connection_state_log(std::chrono::milliseconds(config.connection_state_log_interval_ms));
+        }
         has_init = true;
     }
     void River::run(bool daemon) {
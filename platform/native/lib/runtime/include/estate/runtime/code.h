@@ -71,7 +71,9 @@ namespace estate {
         Launcher_TimedOutWhileGettingWorkerProcess = 58,
         Launcher_FailedToSpawnWorkerProcess = 59,
         WorkerProcess_WrongWorkerId = 60,
-        WorkerProcess_WorkerDeleted = 61
+        WorkerProcess_WorkerDeleted = 61,
+        Innerspace_RequestTimeout = 62,
+        ScriptEngine_ExecutionTimeout = 63
     };
 
     inline const char* get_code_name(Code c) {
@@ -200,6 +202,10 @@ namespace estate {
                 return "WorkerProcess_WrongWorkerId";
             case Code::WorkerProcess_WorkerDeleted:
                 return "WorkerProcess_WorkerDeleted";
+            case Code::Innerspace_RequestTimeout:
+                return "Innerspace_RequestTimeout";
+            case Code::ScriptEngine_ExecutionTimeout:
+                return "ScriptEngine_ExecutionTimeout";
             default:
                 assert(false); //not found
         }
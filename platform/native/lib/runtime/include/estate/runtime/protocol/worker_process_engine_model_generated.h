@@ -25,7 +25,8 @@ struct CellProto FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   struct Traits;
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
     VT_CHECKSUM = 4,
-    VT_VALUE_BYTES = 6
+    VT_VALUE_BYTES = 6,
+    VT_CHECKSUM_VERSION = 8
   };
   uint32_t checksum() const {
     return GetField<uint32_t>(VT_CHECKSUM, 0);
@@ -36,11 +37,15 @@ struct CellProto FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   const ValueProto *value_bytes_nested_root() const {
     return flatbuffers::GetRoot<ValueProto>(value_bytes()->Data());
   }
+  uint8_t checksum_version() const {
+    return GetField<uint8_t>(VT_CHECKSUM_VERSION, 0);
+  }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyField<uint32_t>(verifier, VT_CHECKSUM) &&
            VerifyOffset(verifier, VT_VALUE_BYTES) &&
            verifier.VerifyVector(value_bytes()) &&
+           VerifyField<uint8_t>(verifier, VT_CHECKSUM_VERSION) &&
            verifier.EndTable();
   }
 };
@@ -55,6 +60,9 @@ struct CellProtoBuilder {
   void add_value_bytes(flatbuffers::Offset<flatbuffers::Vector<uint8_t>> value_bytes) {
     fbb_.AddOffset(CellProto::VT_VALUE_BYTES, value_bytes);
   }
+  void add_checksum_version(uint8_t checksum_version) {
+    fbb_.AddElement<uint8_t>(CellProto::VT_CHECKSUM_VERSION, checksum_version, 0);
+  }
   explicit CellProtoBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -69,10 +77,12 @@ struct CellProtoBuilder {
 inline flatbuffers::Offset<CellProto> CreateCellProto(
     flatbuffers::FlatBufferBuilder &_fbb,
     uint32_t checksum = 0,
-    flatbuffers::Offset<flatbuffers::Vector<uint8_t>> value_bytes = 0) {
+    flatbuffers::Offset<flatbuffers::Vector<uint8_t>> value_bytes = 0,
+    uint8_t checksum_version = 0) {
   CellProtoBuilder builder_(_fbb);
   builder_.add_value_bytes(value_bytes);
   builder_.add_checksum(checksum);
+  builder_.add_checksum_version(checksum_version);
   return builder_.Finish();
 }
 
@@ -84,12 +94,14 @@ struct CellProto::Traits {
 inline flatbuffers::Offset<CellProto> CreateCellProtoDirect(
     flatbuffers::FlatBufferBuilder &_fbb,
     uint32_t checksum = 0,
-    const std::vector<uint8_t> *value_bytes = nullptr) {
+    const std::vector<uint8_t> *value_bytes = nullptr,
+    uint8_t checksum_version = 0) {
   auto value_bytes__ = value_bytes ? _fbb.CreateVector<uint8_t>(*value_bytes) : 0;
   return CreateCellProto(
       _fbb,
       checksum,
-      value_bytes__);
+      value_bytes__,
+      checksum_version);
 }
 
 struct EngineSourceProto FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
@@ -13,7 +13,7 @@
 
 #define ADMIN_RESPOND_ERROR_CODE(lc, code) \
             auto response_buffer = ADMIN_CREATE_ERROR_CODE_RESPONSE(code); \
-            request_context->async_respond(lc, response_buffer.get_view(), std::nullopt)
+            request_context->async_respond(lc, response_buffer, std::nullopt)
 
 #define ADMIN_UNWRAP_OR_RESPOND_ERROR_CODE(v, f) \
         auto __##v##_r = f; \
@@ -71,7 +71,9 @@ namespace estate {
     void execute(const SetupWorkerProcessorConfig &config,
                  SetupServiceProviderS service_provider,
                  TRequestBuffer &&request_buffer,
-                 TRequestContextS request_context) {
+                 TRequestContextS request_context,
+                 WorkQueue &,
+                 NoExecutorStats &) {
 
 #define ADMIN_CREATE_ERROR_CODE_RESPONSE(code) create_setup_worker_error_code_response(service_provider->get_buffer_pool(), code)
 
@@ -118,14 +120,14 @@ namespace estate {
                 log_error(log_context, "Responding with error {}", get_code_name(error.get_code()));
                 auto response_buffer = create_setup_worker_error_code_response(service_provider->get_buffer_pool(),
                                                                              error.get_code());
-                request_context->async_respond(log_context, response_buffer.get_view(), std::nullopt);
+                request_context->async_respond(log_context, response_buffer, std::nullopt);
                 return;
             } else {
                 assert(error.is_exception());
                 log_error(log_context, "Responding with script exception");
                 auto response_buffer = create_setup_worker_exception_response(service_provider->get_buffer_pool(),
                                                                             error.get_exception());
-                request_context->async_respond(log_context, response_buffer.get_view(), std::nullopt);
+                request_context->async_respond(log_context, response_buffer, std::nullopt);
                 return;
             }
         }
@@ -138,7 +140,7 @@ namespace estate {
         log_trace(log_context, "Responding OK");
         {
             auto response_buffer = create_setup_worker_ok_response(service_provider->get_buffer_pool());
-            request_context->async_respond(std::move(log_context), response_buffer.get_view(), std::nullopt);
+            request_context->async_respond(std::move(log_context), response_buffer, std::nullopt);
         }
 
 #undef ADMIN_CREATE_ERROR_CODE_RESPONSE
@@ -151,6 +153,7 @@ namespace estate {
             SetupServiceProvider,
             SetupWorkerRequestContext,
             SetupWorkerRequestEnvelope,
+            NoExecutorStats,
             execute>;
 }
 
@@ -236,7 +239,9 @@ namespace estate {
     void execute(const DeleteWorkerProcessorConfig &config,
                  DeleteServiceProviderS service_provider,
                  TRequestBuffer&& request_buffer,
-                 TRequestContextS request_context) {
+                 TRequestContextS request_context,
+                 WorkQueue &,
+                 NoExecutorStats &) {
 
 #define ADMIN_CREATE_ERROR_CODE_RESPONSE(code) create_delete_worker_error_code_response(service_provider->get_buffer_pool(), code)
 
@@ -279,12 +284,12 @@ namespace estate {
             if(config.shutdown_on_delete) {
                 auto shutdown_requestor = service_provider->get_shutdown_requestor();
                 auto worker_process_table = service_provider->get_worker_process_table();
-                request_context->async_respond(log_context, response_buffer.get_view(), [worker_id, log_context, shutdown_requestor, worker_process_table]() {
+                request_context->async_respond(log_context, response_buffer, [worker_id, log_context, shutdown_requestor, worker_process_table]() {
                     worker_process_table->mark_worker_process_deleted(log_context, worker_id);
                     shutdown_requestor->request_shutdown();
                 });
             } else {
-                request_context->async_respond(log_context, response_buffer.get_view(), std::nullopt);
+                request_context->async_respond(log_context, response_buffer, std::nullopt);
             }
         }
 #undef ADMIN_CREATE_ERROR_CODE_RESPONSE
@@ -297,6 +302,7 @@ namespace estate {
             DeleteServiceProvider,
             DeleteWorkerRequestContext,
             DeleteWorkerRequestEnvelope,
+            NoExecutorStats,
             execute>;
 }
 
@@ -14,7 +14,7 @@
 
 #define SERENITY_RESPOND_ERROR_CODE(lc, code) \
             auto response_buffer = SERENITY_CREATE_ERROR_CODE_RESPONSE(code); \
-            request_context->async_respond(lc, response_buffer.get_view(), std::nullopt)
+            request_context->async_respond(lc, response_buffer, std::nullopt)
 
 #define SERENITY_WORKED_OR_RESPOND_ERROR_CODE(f) \
             { \
@@ -68,7 +68,9 @@ namespace estate {
     void execute(const GetWorkerProcessEndpointProcessorConfig &config,
                  GetWorkerProcessEndpointServiceProviderS service_provider,
                  TRequestBuffer &&request_buffer,
-                 TRequestContextS request_context) {
+                 TRequestContextS request_context,
+                 WorkQueue &,
+                 NoExecutorStats &) {
 
 #define SERENITY_CREATE_ERROR_CODE_RESPONSE(code) create_get_worker_process_endpoint_error_code_response(service_provider->get_buffer_pool(), code)
 
@@ -87,13 +89,13 @@ namespace estate {
         if(!endpoint_r) {
             log_error(log_context, "WorkerLoader encountered an error when requesting WorkerProcess for the WorkerId {}: Error Code: {}", request->worker_id(), get_code_name(endpoint_r.get_error()));
             const auto response_buffer = create_get_worker_process_endpoint_error_code_response(buffer_pool, endpoint_r.get_error());
-            request_context->async_respond(std::move(log_context), response_buffer.get_view(), std::nullopt);
+            request_context->async_respond(std::move(log_context), response_buffer, std::nullopt);
         } else {
             auto endpoint = endpoint_r.unwrap();
             log_trace(log_context, "WorkerLoader received endpoint setup_worker: {}, delete_worker: {}, user_worker: {} for the WorkerId: {}",
                       endpoint.setup_worker_port, endpoint.delete_worker_port, endpoint.user_port, request->worker_id());
             const auto response_buffer = create_get_worker_process_endpoint_ok_response(buffer_pool, endpoint);
-            request_context->async_respond(std::move(log_context), response_buffer.get_view(), std::nullopt);
+            request_context->async_respond(std::move(log_context), response_buffer, std::nullopt);
         }
     }
 
@@ -104,6 +106,7 @@ namespace estate {
             GetWorkerProcessEndpointServiceProvider,
             GetWorkerProcessEndpointRequestContext,
             GetWorkerProcessEndpointRequestEnvelope,
+            NoExecutorStats,
             execute>;
 }
 
@@ -9,9 +9,14 @@
 #include <estate/internal/processor/service_provider/script_engine_service_provider.h>
 #include <estate/internal/local_config.h>
 
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <algorithm>
+
 #define RESPOND_ERROR_CODE(lc, code, conlog) \
     log_error(lc, "Responding with error {}", get_code_name(code)); \
-    request_context->async_respond(lc, create_error_code_user_response(service_provider->get_buffer_pool(), code, conlog).get_view(), std::nullopt)
+    request_context->async_respond(lc, create_error_code_user_response(service_provider->get_buffer_pool(), code, conlog), std::nullopt)
 #define UNWRAP_OR_ERROR_LC(v, f, e, lc, conlog) \
     auto __##v = f; \
     if (!__##v) { \
@@ -41,22 +46,143 @@ namespace estate {
 
     struct UserProcessorConfig {
         WorkerId worker_id;
+        u32 max_commit_retries{0}; //0 returns write conflicts to the client, otherwise service calls are re-run this many times
+        u32 commit_retry_backoff_ms{0}; //doubled each retry
+        u32 max_commit_retry_backoff_ms{0};
         static UserProcessorConfig Create(WorkerId worker_id) {
             return UserProcessorConfig {
                 worker_id
             };
         }
+        static UserProcessorConfig FromRemoteWithWorkerId(const LocalConfigurationReader &reader, WorkerId worker_id) {
+            return UserProcessorConfig{
+                    worker_id,
+                    reader.get_u32("max_commit_retries", 0),
+                    reader.get_u32("commit_retry_backoff_ms", 0),
+                    reader.get_u32("max_commit_retry_backoff_ms", 0)
+            };
+        }
+    };
+
+    // The UserProcessor's totals since it started, logged whenever a service call is retried. Copies are snapshots.
+    struct CommitRetryMetrics {
+        std::atomic<u64> conflicts{0};
+        std::atomic<u64> retries{0};
+        std::atomic<u64> exhausted{0}; //conflicts returned to the client after the last retry
+        CommitRetryMetrics() = default;
+        CommitRetryMetrics(const CommitRetryMetrics &other) :
+                conflicts(other.conflicts.load()), retries(other.retries.load()), exhausted(other.exhausted.load()) {}
     };
 
+    // How long to wait before retrying, with jitter so calls that conflicted with each other don't retry in lockstep.
+    inline std::chrono::milliseconds get_commit_retry_backoff(const UserProcessorConfig &config, u32 attempt) {
+        if (config.commit_retry_backoff_ms == 0)
+            return std::chrono::milliseconds{0};
+        const u64 backoff_ms = std::min<u64>(static_cast<u64>(config.commit_retry_backoff_ms) << std::min<u32>(attempt, 16),
+                                             std::max(config.commit_retry_backoff_ms, config.max_commit_retry_backoff_ms));
+        thread_local std::minstd_rand random{std::random_device{}()};
+        std::uniform_int_distribution<u64> jitter{backoff_ms / 2, backoff_ms};
+        return std::chrono::milliseconds(jitter(random));
+    }
+
+    /* Calls to the same service object would conflict on commit when run together, so they're run one at a time. The key is the
+     * service's class id and primary key. */
+    inline std::optional<std::string> get_call_service_method_ordering_key(const UserRequestProto *request) {
+        if (request->request_type() != UserRequestUnionProto::CallServiceMethodRequestProto)
+            return std::nullopt;
+        const auto inner_request = request->request_as_CallServiceMethodRequestProto();
+        if (!inner_request->primary_key())
+            return std::nullopt; //no primary key to order on
+        std::string key{fmt::format("{}:", inner_request->class_id())};
+        key.append(inner_request->primary_key()->string_view());
+        return key;
+    }
+
     Buffer<WorkerProcessUserResponseProto> create_error_code_user_response(BufferPoolS buffer_pool, Code code, std::optional<engine::ConsoleLogS> console_log);
 
     Buffer<WorkerProcessUserResponseProto> create_exception_user_response(BufferPoolS buffer_pool, const engine::ScriptException &ex, std::optional<engine::ConsoleLogS> console_log);
 
+    /* Runs one attempt of a service call. Write conflicts are retried with a new transaction and working set, so the method sees the
+     * other call's changes. The retry is posted back to the work queue after the backoff rather than waiting on this thread. */
+    template<typename TRequestContextS, typename TRequestBuffer>
+    void call_service_method(const UserProcessorConfig &config,
+                             UserServiceProviderS service_provider,
+                             TRequestBuffer &&request_buffer,
+                             TRequestContextS request_context,
+                             WorkQueue &work_queue,
+                             CommitRetryMetrics &commit_retry_metrics,
+                             const LogContext &log_context,
+                             storage::IDatabaseS db,
+                             u32 attempt) {
+        const UserRequestProto *request = request_buffer.get_payload();
+        const auto inner_request = request->request_as_CallServiceMethodRequestProto();
+
+        UNWRAP_OR_FORWARD(txn, db->create_transaction(log_context, request->worker_version()), std::nullopt);
+        auto call_context = std::make_shared<engine::CallContext>(log_context, txn, service_provider->get_buffer_pool(), true);
+
+        auto console_log = call_context->get_console_log();
+
+        auto engine_result = service_provider->get_object_runtime()->call_service_method(call_context, inner_request);
+
+        if (engine_result) {
+            auto result = engine_result.unwrap();
+            if (result.has_changes) {
+                log_trace(log_context, "Comitting the transaction");
+                auto commit_r = txn->commit();
+                if (!commit_r) {
+                    const auto code = commit_r.get_error();
+                    if (code == Code::Datastore_WriteConflictTryAgain) {
+                        ++commit_retry_metrics.conflicts;
+                        if (attempt < config.max_commit_retries) {
+                            const auto retries = ++commit_retry_metrics.retries;
+                            log_info(log_context, "Retrying CallServiceMethod after a write conflict, attempt {} of {} ({} retries, {} conflicts total)",
+                                     attempt + 1, config.max_commit_retries, retries, commit_retry_metrics.conflicts.load());
+                            auto key = get_call_service_method_ordering_key(request);
+                            const auto backoff = get_commit_retry_backoff(config, attempt);
+                            work_queue.post_after(std::move(key), backoff,
+                                                  [&config, &work_queue, &commit_retry_metrics, service_provider, request_buffer{std::move(request_buffer)},
+                                                          request_context, log_context, db, attempt]() mutable {
+                                                      call_service_method(config, std::move(service_provider), std::move(request_buffer),
+                                                                          std::move(request_context), work_queue, commit_retry_metrics, log_context,
+                                                                          std::move(db), attempt + 1);
+                                                  });
+                            return;
+                        }
+                        if (config.max_commit_retries > 0) {
+                            const auto exhausted = ++commit_retry_metrics.exhausted;
+                            log_warn(log_context, "CallServiceMethod still conflicted after {} retries ({} exhausted total)",
+                                     config.max_commit_retries, exhausted);
+                        }
+                    }
+                    RESPOND_ERROR_CODE(log_context, code, console_log);
+                    return;
+                }
+            }
+            request_context->async_respond(log_context, result.response, std::nullopt);
+            log_info(log_context, "CallServiceMethod request completed successfully");
+        } else {
+            auto error = engine_result.get_error();
+            if (error.is_code()) {
+                log_error(log_context, "Responding with error {}", get_code_name(error.get_code()));
+                auto response_buffer = create_error_code_user_response(service_provider->get_buffer_pool(),
+                                                                       error.get_code(), console_log);
+                request_context->async_respond(log_context, response_buffer, std::nullopt);
+            } else {
+                assert(error.is_exception());
+                log_error(log_context, "Responding with script exception");
+                request_context->async_respond(log_context, create_exception_user_response(service_provider->get_buffer_pool(),
+                                                                                           error.get_exception(), console_log), std::nullopt);
+            }
+        }
+    }
+
     template<typename TRequestContextS, typename TRequestBuffer>
     void execute(const UserProcessorConfig &config,
                  UserServiceProviderS service_provider,
                  TRequestBuffer &&request_buffer,
-                 TRequestContextS request_context) {
+                 TRequestContextS request_context,
+                 WorkQueue &work_queue,
+                 CommitRetryMetrics &commit_retry_metrics) {
 
         const UserRequestProto *request = request_buffer.get_payload();
 
@@ -77,7 +203,7 @@ namespace estate {
         //Handle the request based on its type
         switch (request->request_type()) {
             case UserRequestUnionProto::GetDataRequestProto: {
-                UNWRAP_OR_FORWARD(txn, db->create_transaction(log_context, request->worker_version()), std::nullopt);
+                UNWRAP_OR_FORWARD(txn, db->create_read_only_transaction(log_context, request->worker_version()), std::nullopt);
 
                 auto inner_request = request->request_as_GetDataRequestProto();
                 const auto ref = make_object_reference(data::ObjectType::WORKER_OBJECT, inner_request->class_id(), PrimaryKey{inner_request->primary_key()->string_view()});
@@ -90,46 +216,17 @@ namespace estate {
                 reusable_builder->Finish(CreateUserResponseUnionWrapperProto(*reusable_builder, UserResponseUnionProto::GetDataResponseProto,
                                                                              CreateGetDataResponseProto(*reusable_builder, data_off).Union()));
 
-                fbs::Builder outer_builder{};
+                PooledBuilder outer_builder{service_provider->get_buffer_pool()};
                 const auto response_bytes_vec_off = outer_builder.CreateVector(reusable_builder->GetBufferPointer(), reusable_builder->GetSize());
-                outer_builder.Finish(CreateWorkerProcessUserResponseProto(outer_builder, response_bytes_vec_off));
+                auto response_buffer = finish_to_buffer(outer_builder, CreateWorkerProcessUserResponseProto(outer_builder, response_bytes_vec_off));
 
-                BufferView<WorkerProcessUserResponseProto> response_view{outer_builder};
-                request_context->async_respond(log_context, response_view, std::nullopt);
+                request_context->async_respond(log_context, std::move(response_buffer), std::nullopt);
                 log_info(log_context, "GetData request completed successfully");
                 break;
             }
             case UserRequestUnionProto::CallServiceMethodRequestProto: {
-                UNWRAP_OR_FORWARD(txn, db->create_transaction(log_context, request->worker_version()), std::nullopt);
-                auto call_context = std::make_shared<engine::CallContext>(log_context, txn, service_provider->get_buffer_pool(), true);
-
-                auto console_log = call_context->get_console_log();
-                const auto inner_request = request->request_as_CallServiceMethodRequestProto();
-
-                auto engine_result = service_provider->get_object_runtime()->call_service_method(call_context, inner_request);
-
-                if (engine_result) {
-                    auto result = engine_result.unwrap();
-                    if (result.has_changes) {
-                        log_trace(log_context, "Comitting the transaction");
-                        WORKED_OR_FORWARD(txn->commit(), console_log);
-                    }
-                    request_context->async_respond(log_context, result.response.get_view(), std::nullopt);
-                    log_info(log_context, "CallServiceMethod request completed successfully");
-                } else {
-                    auto error = engine_result.get_error();
-                    if (error.is_code()) {
-                        log_error(log_context, "Responding with error {}", get_code_name(error.get_code()));
-                        auto response_buffer = create_error_code_user_response(service_provider->get_buffer_pool(),
-                                                                               error.get_code(), console_log);
-                        request_context->async_respond(log_context, response_buffer.get_view(), std::nullopt);
-                    } else {
-                        assert(error.is_exception());
-                        log_error(log_context, "Responding with script exception");
-                        request_context->async_respond(log_context, create_exception_user_response(service_provider->get_buffer_pool(),
-                                                                                                   error.get_exception(), console_log).get_view(), std::nullopt);
-                    }
-                }
+                call_service_method(config, std::move(service_provider), std::move(request_buffer), std::move(request_context), work_queue,
+                                    commit_retry_metrics, log_context, std::move(db), 0);
                 break;
             }
             case UserRequestUnionProto::SaveDataRequestProto: {
@@ -184,18 +281,19 @@ namespace estate {
                                                             CreateSaveDataResponseProto(*reusable_builder,
                                                                                                reusable_builder->CreateVector(handle_offsets)).Union()));
 
-                fbs::Builder outer_builder{};
-                outer_builder.Finish(CreateWorkerProcessUserResponseProto(outer_builder,
-                                                                     outer_builder.CreateVector(reusable_builder->GetBufferPointer(), reusable_builder->GetSize()),
-                                                                     delta_bytes_off));
+                PooledBuilder outer_builder{buffer_pool};
+                auto response_buffer = finish_to_buffer(outer_builder,
+                                                        CreateWorkerProcessUserResponseProto(outer_builder,
+                                                                                             outer_builder.CreateVector(reusable_builder->GetBufferPointer(),
+                                                                                                                        reusable_builder->GetSize()),
+                                                                                             delta_bytes_off));
 
                 if (has_changes) {
                     log_trace(log_context, "Comitting the transaction");
                     WORKED_OR_FORWARD(txn->commit(), std::nullopt);
                 }
 
-                BufferView<WorkerProcessUserResponseProto> response_view{outer_builder};
-                request_context->async_respond(log_context, response_view, std::nullopt);
+                request_context->async_respond(log_context, std::move(response_buffer), std::nullopt);
                 log_info(log_context, "SaveData request completed successfully");
                 break;
             }
@@ -207,6 +305,10 @@ namespace estate {
         }
     }
 
+    inline std::optional<std::string> get_user_request_ordering_key(UserRequestEnvelope &request_buffer) {
+        return get_call_service_method_ordering_key(request_buffer.get_payload());
+    }
+
     using UserProcessor = Processor<
             UserProcessorConfig,
             UserRequestProto,
@@ -214,5 +316,7 @@ namespace estate {
             UserServiceProvider,
             UserRequestContext,
             UserRequestEnvelope,
-            execute>;
+            CommitRetryMetrics,
+            execute,
+            get_user_request_ordering_key>;
 }
@@ -11,6 +11,7 @@
 #include "estate/internal/server/server.h"
 #include "estate/runtime/version.h"
 #include <iostream>
+#include <thread>
 #include "estate/internal/deps/boost.h"
 
 namespace estate {
@@ -24,6 +25,7 @@ namespace estate {
         template<typename... SPArgs>
         void init(const ProcessorConfig &processor_config,
                   const ServerConfig &server_config,
+                  const WorkQueueConfig &work_queue_config,
                   BufferPoolS buffer_pool,
                   ThreadPoolS thread_pool,
                   SPArgs... spargs) {
@@ -33,7 +35,7 @@ namespace estate {
 
             assert(!has_init);
             service_provider = std::make_shared<ServiceProvider>(std::forward<SPArgs>(spargs)...);
-            processor = std::make_shared<TProcessor>(processor_config, service_provider);
+            processor = std::make_shared<TProcessor>(processor_config, service_provider, work_queue_config);
             server = TInnerspace::CreateServer(server_config, buffer_pool, thread_pool->get_context(),
                                                [m = processor](ConnectionS connection, RequestEnvelope &&request_envelope) mutable {
                                                    auto request_context = std::make_shared<RequestContext>(connection,
@@ -47,6 +49,10 @@ namespace estate {
         }
         void shutdown() {
             server->shutdown();
+            processor->shutdown();
+        }
+        [[nodiscard]] auto get_stats() const {
+            return processor->get_stats();
         }
 
     private:
@@ -56,6 +62,21 @@ namespace estate {
         std::shared_ptr<Server> server{};
         std::atomic_bool has_init{false};
     };
+    /* How many engines are created in the background when a WorkerProcess starts, so the first requests don't pay for isolate creation.
+     * When adaptive, the peak number of engines in use is saved at shutdown and the next start warms up to that many, halving it
+     * each restart it isn't reached again. */
+    struct EngineWarmingConfig {
+        u32 min_engine_count{0};
+        u32 max_engine_count{0};
+        bool adaptive{false};
+        static EngineWarmingConfig FromRemote(const LocalConfigurationReader &reader) {
+            return EngineWarmingConfig{
+                    reader.get_u32("min_engine_count", 0),
+                    reader.get_u32("max_engine_count", 0),
+                    reader.get_bool("adaptive", false)
+            };
+        }
+    };
     struct WorkerProcess : public std::enable_shared_from_this<WorkerProcess> {
         enum class SupportedCommand : u8 {
             None = 0,
@@ -76,6 +97,10 @@ namespace estate {
             SetupWorkerInnerspace::Server::Config setup_worker_server_config{};
             DeleteWorkerProcessorConfig delete_worker_processor_config{};
             DeleteWorkerInnerspace::Server::Config delete_worker_server_config{};
+            //only user requests run script long enough to need their own threads, admin requests run inline
+            WorkQueueConfig user_work_queue_config{};
+            EngineWarmingConfig engine_warming_config{};
+            PoolConfig engine_pool_config{};
             bool has_command(SupportedCommand command) const;
         };
         bool has_init{false};
@@ -85,6 +110,11 @@ namespace estate {
         BufferPoolS buffer_pool{};
         std::atomic_bool keep_running_daemon;
 
+        engine::IObjectRuntimeS js_object_runtime{};
+        std::optional<std::thread> engine_warming_thread{};
+        std::atomic_bool stop_engine_warming{false};
+        std::optional<boost::asio::steady_timer> engine_eviction_timer{};
+
         std::optional<WorkerProcessSystem<UserProcessor, UserInnerspace>> user_system;
         std::optional<WorkerProcessSystem<SetupWorkerProcessor, SetupWorkerInnerspace>> setup_worker_system;
         std::optional<WorkerProcessSystem<DeleteWorkerProcessor, DeleteWorkerInnerspace>> delete_worker_system;
@@ -94,6 +124,13 @@ namespace estate {
         void init(WorkerProcessTableS worker_process_table, const Config &config);
         void start();
         void run_daemon();
+    private:
+        void warm_engines(WorkerId worker_id, EngineWarmingConfig engine_warming_config);
+        void save_warm_engine_count(WorkerId worker_id, const EngineWarmingConfig &engine_warming_config);
+        void schedule_engine_eviction(std::chrono::milliseconds interval);
+        WorkerId worker_id{};
+        EngineWarmingConfig engine_warming_config{};
+        u32 engine_pool_idle_timeout_ms{0};
     };
     using WorkerProcessS = std::shared_ptr<WorkerProcess>;
 }
@@ -34,12 +34,18 @@ namespace estate {
         u16 worker_process_wait_secs;
         u16 port_start;
         u16 port_end;
+        //when set worker processes listen on AF_UNIX sockets named after their WorkerId so no ports are handed out
+        std::string local_socket_dir{};
+        [[nodiscard]] bool uses_local_sockets() const {
+            return !local_socket_dir.empty();
+        }
         static WorkerProcessTableConfig FromRemote(const LocalConfigurationReader &reader) {
             return WorkerProcessTableConfig{
                     reader.get_u16("launcher_wait_secs"),
                     reader.get_u16("worker_process_wait_secs"),
                     reader.get_u16("port_start"),
                     reader.get_u16("port_end"),
+                    reader.get_string("local_socket_dir", "")
             };
         }
     };
@@ -81,6 +87,10 @@ namespace estate {
         WorkerProcessTableLock *_lock;
         const u16 _launcher_wait_secs;
         const u16 _worker_process_wait_secs;
+        const bool _uses_local_sockets;
+        // Both require the changes lock.
+        void reclaim_ports(const WorkerProcessEndpoint &endpoint);
+        std::optional<WorkerProcessEndpoint> take_ports();
     };
     using WorkerProcessTableS = std::shared_ptr<WorkerProcessTable>;
 }
\ No newline at end of file
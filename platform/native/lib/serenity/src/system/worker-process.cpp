@@ -5,10 +5,13 @@
 #include "estate/internal/serenity/system/worker-process.h"
 
 #include <estate/internal/net_util.h>
+#include <estate/internal/innerspace/innerspace-client.h>
+#include <estate/internal/stopwatch.h>
 #include <estate/runtime/enum_op.h>
 #include <estate/runtime/version.h>
 #include <iostream>
 #include <cassert>
+#include <algorithm>
 
 namespace estate {
     WorkerProcess::Config WorkerProcess::LoadConfig(SupportedCommand supported_commands, WorkerId worker_id, u16 setup_worker_port, u16 delete_worker_port, u16 user_port) {
@@ -21,25 +24,50 @@ namespace estate {
                 storage::DatabaseManagerConfiguration::FromRemote(local_configuration.create_reader("DatabaseManager")),
                 LoggingConfig::FromRemoteWithWorkerId(local_configuration.create_reader("Logging"), worker_id),
                 supported_commands,
-                UserProcessorConfig::Create(worker_id),
-                UserInnerspace::Server::Config::FromRemoteWithoutPort(local_configuration.create_reader("UserInnerspaceServer"), user_port),
+                UserProcessorConfig::FromRemoteWithWorkerId(local_configuration.create_reader("UserProcessor"), worker_id),
+                UserInnerspace::Server::Config::FromRemoteWithoutPort(local_configuration.create_reader("UserInnerspaceServer"), user_port,
+                                                                      innerspace::make_worker_process_socket_name(worker_id, INNERSPACE_USER_SOCKET_KIND)),
                 SetupWorkerProcessorConfig::Create(worker_id),
-                SetupWorkerInnerspace::Server::Config::FromRemoteWithoutPort(local_configuration.create_reader("SetupWorkerInnerspaceServer"), setup_worker_port),
+                SetupWorkerInnerspace::Server::Config::FromRemoteWithoutPort(local_configuration.create_reader("SetupWorkerInnerspaceServer"), setup_worker_port,
+                                                                             innerspace::make_worker_process_socket_name(worker_id, INNERSPACE_SETUP_WORKER_SOCKET_KIND)),
                 DeleteWorkerProcessorConfig::FromRemoteWithWorkerId(local_configuration.create_reader("DeleteWorkerProcessor"), worker_id),
-                DeleteWorkerInnerspace::Server::Config::FromRemoteWithoutPort(local_configuration.create_reader("DeleteWorkerInnerspaceServer"), delete_worker_port)
+                DeleteWorkerInnerspace::Server::Config::FromRemoteWithoutPort(local_configuration.create_reader("DeleteWorkerInnerspaceServer"), delete_worker_port,
+                                                                              innerspace::make_worker_process_socket_name(worker_id, INNERSPACE_DELETE_WORKER_SOCKET_KIND)),
+                WorkQueueConfig::FromRemote(local_configuration.create_reader("UserWorkQueue")),
+                EngineWarmingConfig::FromRemote(local_configuration.create_reader("EngineWarming")),
+                PoolConfig::FromRemote(local_configuration.create_reader("EnginePool"))
         };
     }
     void WorkerProcess::shutdown() {
         sys_log_info("Shutting down");
 
+        if (engine_warming_thread) {
+            sys_log_trace("Stopping engine warming");
+            stop_engine_warming = true;
+            engine_warming_thread.value().join();
+            engine_warming_thread.reset();
+            sys_log_trace("Engine warming stopped");
+        }
+
+        if (js_object_runtime) {
+            save_warm_engine_count(worker_id, engine_warming_config);
+        }
+
         sys_log_trace("Shutting down thread pool");
         thread_pool->shutdown();
         thread_pool = nullptr;
         sys_log_trace("Thread pool shut down");
 
+        // The pool is stopped, so the eviction handler can no longer re-arm the timer
+        engine_eviction_timer.reset();
+
         if (user_system) {
             sys_log_trace("Shutting down CallMethod system");
             user_system.value().shutdown();
+            const auto stats = user_system.value().get_stats();
+            sys_log_info("CallMethod system ran {} requests, {} write conflicts, {} commit retries, {} conflicts after the last retry",
+                         stats.work_queue.executed, stats.executor.conflicts.load(), stats.executor.retries.load(),
+                         stats.executor.exhausted.load());
             user_system.reset();
             sys_log_trace("CallMethod system shut down");
         }
@@ -70,6 +98,78 @@ namespace estate {
 
         sys_log_info("Estate WorkerProcess shut down cleanly");
     }
+    void WorkerProcess::warm_engines(const WorkerId worker_id, const EngineWarmingConfig engine_warming_config) {
+        const LogContext log_context{fmt::format("engine-warming-{}", worker_id)};
+
+        // A worker that hasn't been setup yet has no database and nothing to warm
+        auto database_r = database_manager->get_database(log_context, worker_id, false, std::nullopt);
+        if (!database_r) {
+            log_trace(log_context, "Not warming engines, the worker's database couldn't be opened: {}", get_code_name(database_r.get_error()));
+            return;
+        }
+        auto database = database_r.unwrap();
+
+        u32 target = engine_warming_config.min_engine_count;
+        if (engine_warming_config.adaptive) {
+            auto warm_engine_count_r = database->get_warm_engine_count(log_context);
+            if (warm_engine_count_r)
+                target = std::max(target, warm_engine_count_r.unwrap());
+        }
+        target = std::min(target, engine_warming_config.max_engine_count);
+
+        auto worker_version_r = database->get_worker_version(log_context);
+        if (!worker_version_r)
+            return;
+        const auto worker_version = worker_version_r.unwrap();
+
+        Stopwatch timing{log_context};
+        u32 warmed{0};
+        while (warmed < target && !stop_engine_warming) {
+            auto txn_r = database->create_transaction(log_context, worker_version);
+            if (!txn_r)
+                break; //a new worker version was setup, requests will create engines for it
+            auto warmed_r = js_object_runtime->warm_engine(log_context, txn_r.unwrap());
+            if (!warmed_r) {
+                log_warn(log_context, "Stopped warming engines after {} of {}, an engine couldn't be created", warmed, target);
+                break;
+            }
+            if (!warmed_r.unwrap())
+                break; //the engine pool is full
+            ++warmed;
+        }
+        timing.log_elapsed(fmt::format("Warmed {} engines", warmed));
+    }
+    void WorkerProcess::schedule_engine_eviction(const std::chrono::milliseconds interval) {
+        engine_eviction_timer.value().expires_after(interval);
+        engine_eviction_timer.value().async_wait([this, interval](const boost::system::error_code &error) {
+            if (error)
+                return; //cancelled at shutdown
+            js_object_runtime->evict_idle_engines();
+            schedule_engine_eviction(interval);
+        });
+    }
+    void WorkerProcess::save_warm_engine_count(const WorkerId worker_id, const EngineWarmingConfig &engine_warming_config) {
+        if (!engine_warming_config.adaptive)
+            return;
+
+        const LogContext log_context{fmt::format("engine-warming-{}", worker_id)};
+
+        auto database_r = database_manager->get_database(log_context, worker_id, false, std::nullopt);
+        if (!database_r)
+            return;
+        auto database = database_r.unwrap();
+
+        // Decay the previous peak so a burst doesn't keep engines warm forever
+        u32 previous{0};
+        auto warm_engine_count_r = database->get_warm_engine_count(log_context);
+        if (warm_engine_count_r)
+            previous = warm_engine_count_r.unwrap();
+        const auto peak = static_cast<u32>(js_object_runtime->get_peak_engine_count(worker_id));
+        const auto warm_engine_count = std::max(peak, previous / 2);
+
+        if (database->save_warm_engine_count(log_context, warm_engine_count))
+            log_trace(log_context, "Saved warm engine count {} (peak {}, previous {})", warm_engine_count, peak, previous);
+    }
     void WorkerProcess::init(WorkerProcessTableS worker_process_table, const Config &config) {
         assert(!has_init);
 
@@ -90,13 +190,16 @@ namespace estate {
         thread_pool = std::make_shared<ThreadPool>(config.thread_pool_config);
         thread_pool->start();
 
-        engine::IObjectRuntimeS js_object_runtime{};
+        worker_id = config.user_processor_config.worker_id;
+        engine_warming_config = config.engine_warming_config;
+        engine_pool_idle_timeout_ms = config.engine_pool_config.idle_timeout_ms;
 
         if (config.has_command(SupportedCommand::User)) {
-            js_object_runtime = engine::javascript::create_object_runtime(config.javascript_config.max_heap_size);
+            js_object_runtime = engine::javascript::create_object_runtime(config.javascript_config.max_heap_size, config.engine_pool_config);
             user_system.emplace();
             user_system.value().init(config.user_processor_config,
                                      config.user_server_config,
+                                     config.user_work_queue_config,
                                      buffer_pool,
                                      thread_pool,
                                      buffer_pool,
@@ -114,6 +217,7 @@ namespace estate {
             });
             delete_worker_system.value().init(config.delete_worker_processor_config,
                                             config.delete_worker_server_config,
+                                            WorkQueueConfig{},
                                             buffer_pool,
                                             thread_pool,
                                             buffer_pool,
@@ -123,10 +227,11 @@ namespace estate {
         }
 
         if (config.has_command(SupportedCommand::SetupWorker)) {
-            auto js_setup_runtime = engine::javascript::create_setup_runtime();
+            auto js_setup_runtime = engine::javascript::create_setup_runtime(config.javascript_config.max_heap_size);
             setup_worker_system.emplace();
             setup_worker_system.value().init(config.setup_worker_processor_config,
                                            config.setup_worker_server_config,
+                                           WorkQueueConfig{},
                                            buffer_pool,
                                            thread_pool,
                                            buffer_pool,
@@ -175,6 +280,17 @@ namespace estate {
 
         if (user_system) {
             user_system.value().start();
+
+            if (engine_warming_config.max_engine_count > 0) {
+                engine_warming_thread.emplace([this]() {
+                    warm_engines(worker_id, engine_warming_config);
+                });
+            }
+
+            if (engine_pool_idle_timeout_ms > 0) {
+                engine_eviction_timer.emplace(*thread_pool->get_context());
+                schedule_engine_eviction(std::chrono::milliseconds(engine_pool_idle_timeout_ms));
+            }
         }
 
         if (delete_worker_system) {
@@ -93,7 +93,8 @@ namespace estate {
     }
 
     WorkerProcessTable::WorkerProcessTable(const WorkerProcessTableConfig &config) :
-            _launcher_wait_secs{config.launcher_wait_secs}, _worker_process_wait_secs{config.worker_process_wait_secs} {
+            _launcher_wait_secs{config.launcher_wait_secs}, _worker_process_wait_secs{config.worker_process_wait_secs},
+            _uses_local_sockets{config.uses_local_sockets()} {
 
         sys_log_trace("Removing previous shared memory objects...");
 
@@ -144,9 +145,11 @@ namespace estate {
         PortsSetAllocatorT ports_alloc(ports_segment.get_segment_manager());
         auto ports = ports_segment.construct<PortsSetT>("ports")(std::less<u16>(), ports_alloc);
 
-        // add all the ports
-        for (u16 p = config.port_start; p <= config.port_end; ++p)
-            ports->insert(p);
+        // add all the ports, worker processes on local sockets don't need any
+        if (!_uses_local_sockets) {
+            for (u16 p = config.port_start; p <= config.port_end; ++p)
+                ports->insert(p);
+        }
 
         _ports_segment = std::move(ports_segment);
         _ports = ports;
@@ -198,9 +201,7 @@ namespace estate {
                         log_trace(log_context, "Reclaiming ports for worker process table entry because the process is no longer running");
 
                         //reclaim the ports since the process is dead
-                        _ports->insert(instance.endpoint.setup_worker_port);
-                        _ports->insert(instance.endpoint.delete_worker_port);
-                        _ports->insert(instance.endpoint.user_port);
+                        reclaim_ports(instance.endpoint);
 
                         // Reset the entry so the launcher knows to start it anew.
                         table[worker_id] = std::move(WorkerProcessTableEntry{});
@@ -297,9 +298,7 @@ namespace estate {
                                 sys_log_trace("(deleted) Reclaiming ports {},{}, and {}", endpoint.setup_worker_port, endpoint.delete_worker_port,
                                               endpoint.user_port);
                                 //Reclaim the ports since the instance is no longer running
-                                _ports->insert(endpoint.setup_worker_port);
-                                _ports->insert(endpoint.delete_worker_port);
-                                _ports->insert(endpoint.user_port);
+                                reclaim_ports(endpoint);
                                 changes_made = true;
                             }
                             to_be_removed.insert(worker_id);
@@ -323,34 +322,19 @@ namespace estate {
                         sys_log_trace("(stopped) Reclaiming ports {},{}, and {}", endpoint.setup_worker_port, endpoint.delete_worker_port,
                                       endpoint.user_port);
 
-                        _ports->insert(endpoint.setup_worker_port);
-                        _ports->insert(endpoint.delete_worker_port);
-                        _ports->insert(endpoint.user_port);
+                        reclaim_ports(endpoint);
 
                         entry.instance = std::nullopt;
                         changes_made = true;
                     }
 
 
-                    if (_ports->size() < 3) {
+                    auto maybe_endpoint = take_ports();
+                    if (!maybe_endpoint.has_value()) {
                         sys_log_critical("Not enough free ports to launch worker process");
                         return LauncherUpdateResult::FAILURE;
                     }
-
-                    const auto setup_worker_port = *_ports->begin();
-                    _ports->erase(_ports->begin());
-
-                    const auto delete_worker_port = *_ports->begin();
-                    _ports->erase(_ports->begin());
-
-                    const auto user_port = *_ports->begin();
-                    _ports->erase(_ports->begin());
-
-                    WorkerProcessEndpoint endpoint{
-                            setup_worker_port,
-                            delete_worker_port,
-                            user_port
-                    };
+                    WorkerProcessEndpoint endpoint = maybe_endpoint.value();
 
                     sys_log_trace("Assigning ports {},{}, and {} to worker id {}", endpoint.setup_worker_port, endpoint.delete_worker_port,
                                   endpoint.user_port, worker_id);
@@ -409,6 +393,30 @@ namespace estate {
             }
         }
     }
+    void WorkerProcessTable::reclaim_ports(const WorkerProcessEndpoint &endpoint) {
+        if (_uses_local_sockets)
+            return;
+        _ports->insert(endpoint.setup_worker_port);
+        _ports->insert(endpoint.delete_worker_port);
+        _ports->insert(endpoint.user_port);
+    }
+    std::optional<WorkerProcessEndpoint> WorkerProcessTable::take_ports() {
+        if (_uses_local_sockets)
+            return WorkerProcessEndpoint{0, 0, 0}; //the sockets are named after the WorkerId
+        if (_ports->size() < 3)
+            return std::nullopt;
+        const auto setup_worker_port = *_ports->begin();
+        _ports->erase(_ports->begin());
+        const auto delete_worker_port = *_ports->begin();
+        _ports->erase(_ports->begin());
+        const auto user_port = *_ports->begin();
+        _ports->erase(_ports->begin());
+        return WorkerProcessEndpoint{
+                setup_worker_port,
+                delete_worker_port,
+                user_port
+        };
+    }
     bool WorkerProcessTableEntry::is_running() const {
         return exists() && is_process_alive(instance.value().pid);
     }
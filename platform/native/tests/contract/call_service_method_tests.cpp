@@ -1502,3 +1502,75 @@ TEST(contract_call_service_method_tests, Duplicate) {
     }
     SUBTEST_END
 }
+
+TEST(contract_call_service_method_tests, CodeCache) {
+    SETUP(1, true, true, false);
+
+    PrimaryKey echo_service_primary_key{std::string{"default"}};
+
+    ClassId echo_service_class_id = 1;
+
+    int m = 100;
+    MethodId method_echo = m++;
+
+    SUBTEST_BEGIN(Setup Saved The Code Caches)
+    {
+        auto database = context.services->database_manager->get_database(*context.log_context, context.package->worker_id, false,
+                                                                          std::nullopt).unwrap();
+        auto txn = database->create_read_only_transaction(*context.log_context, context.package->worker_version).unwrap();
+        auto factory_code_cache = txn->maybe_get_code_cache(ESTATE_FACTORY_MODULE_CODE_CACHE_ID).unwrap();
+        ASSERT_TRUE(factory_code_cache.has_value());
+        ASSERT_GT(factory_code_cache->size(), 0);
+        auto module_code_cache = txn->maybe_get_code_cache(1).unwrap();
+        ASSERT_TRUE(module_code_cache.has_value());
+        ASSERT_GT(module_code_cache->size(), 0);
+    }
+    SUBTEST_END
+
+    SUBTEST_BEGIN(Engine Compiled From The Code Caches)
+    {
+        for (int i = 0; i < 2; ++i) {
+            std::vector<fbs::Offset<ValueProto>> arguments{
+                    CreateValueProto(context.builder, ValueUnionProto::StringValueProto,
+                                     CreateStringValueProto(context.builder, context.builder.CreateString("cached")).Union())
+            };
+            const auto response = context.call_service_method(echo_service_class_id, echo_service_primary_key, method_echo,
+                                                              std::move(arguments), std::nullopt);
+            ASSERT_EQ(response->response_nested_root()->value_type(), UserResponseUnionProto::CallServiceMethodResponseProto);
+            const auto return_value = response->response_nested_root()->value_as_CallServiceMethodResponseProto()->return_value();
+            ASSERT_EQ(return_value->value_type(), ValueUnionProto::StringValueProto);
+            ASSERT_EQ(return_value->value_as_StringValueProto()->value()->str(), "cached");
+        }
+    }
+    SUBTEST_END
+}
+
+TEST(contract_call_service_method_tests, ExecutionTimeout) {
+    SETUP(1, true, true, false);
+
+    PrimaryKey loop_service_primary_key{std::string{"default"}};
+
+    ClassId loop_service_class_id = 1;
+
+    int m = 100;
+    MethodId method_loopForever = m++;
+    MethodId method_ping = m++;
+
+    SUBTEST_BEGIN(Infinite Loop Is Terminated)
+    {
+        const auto response = context.call_service_method(loop_service_class_id, loop_service_primary_key, method_loopForever,
+                                                          std::nullopt, std::nullopt, Code::ScriptEngine_ExecutionTimeout);
+    }
+    SUBTEST_END
+
+    SUBTEST_BEGIN(Engine Is Usable After A Timeout)
+    {
+        const auto response = context.call_service_method(loop_service_class_id, loop_service_primary_key, method_ping,
+                                                          std::nullopt, std::nullopt);
+        ASSERT_EQ(response->response_nested_root()->value_type(), UserResponseUnionProto::CallServiceMethodResponseProto);
+        const auto return_value = response->response_nested_root()->value_as_CallServiceMethodResponseProto()->return_value();
+        ASSERT_EQ(return_value->value_type(), ValueUnionProto::StringValueProto);
+        ASSERT_EQ(return_value->value_as_StringValueProto()->value()->str(), "pong");
+    }
+    SUBTEST_END
+}
@@ -6,10 +6,36 @@
 #include <estate/internal/flatbuffers_util.h>
 #include "../logging.h"
 
+#include <thread>
+
 using namespace estate;
 
-TEST(contract_innerspace_tests, SingleRequest) {
-    using Innerspace = Innerspace<DeleteWorkerRequestProto, DeleteWorkerResponseProto>;
+using DeleteWorkerInnerspace = Innerspace<DeleteWorkerRequestProto, DeleteWorkerResponseProto>;
+
+DeleteWorkerInnerspace::Server::Config make_server_config(bool local) {
+    return DeleteWorkerInnerspace::Server::Config{
+            local ? make_local_endpoint(boost::filesystem::temp_directory_path().string(), 50000) :
+            StreamEndpoint{make_endpoint("0.0.0.0", 50000)},
+            1024,
+            100
+    };
+}
+
+DeleteWorkerInnerspace::Client::Config make_client_config(bool local, u8 connections) {
+    DeleteWorkerInnerspace::Client::Config config{
+            "localhost",
+            50000,
+            connections,
+            1024,
+            100
+    };
+    if (local)
+        config.local_socket_dir = boost::filesystem::temp_directory_path().string();
+    return config;
+}
+
+void single_request(bool local) {
+    using Innerspace = DeleteWorkerInnerspace;
 
     BufferPoolConfig buffer_pool_config{
             false
@@ -21,11 +47,7 @@ TEST(contract_innerspace_tests, SingleRequest) {
     auto server_thread_pool = std::make_shared<ThreadPool>(server_thread_pool_config);
     server_thread_pool->start();
 
-    Innerspace::Server::Config server_config{
-            make_endpoint("0.0.0.0", 50000),
-            1024,
-            100
-    };
+    Innerspace::Server::Config server_config = make_server_config(local);
     auto server = Innerspace::CreateServer(
             server_config, buffer_pool, server_thread_pool->get_context(),
             [buffer_pool](Innerspace::Server::ServerConnectionS connection, Innerspace::RequestEnvelope &&request_envelope) {
@@ -51,7 +73,7 @@ TEST(contract_innerspace_tests, SingleRequest) {
                                                                                           buffer_pool,
                                                                                           CreateDeleteWorkerResponseProto(builder));
 
-                connection->async_send_response(std::move(lc), request_id, response_buffer.get_view(), std::nullopt);
+                connection->async_send_response(std::move(lc), request_id, response_buffer, std::nullopt);
             });
     server->start();
 
@@ -62,13 +84,7 @@ TEST(contract_innerspace_tests, SingleRequest) {
     auto client_thread_pool = std::make_shared<ThreadPool>(thread_pool_config);
     client_thread_pool->start();
 
-    Innerspace::Client::Config config{
-            "localhost",
-            50000,
-            4,
-            1024,
-            100
-    };
+    Innerspace::Client::Config config = make_client_config(local, 4);
     auto client = Innerspace::CreateClient(config, buffer_pool, client_thread_pool->get_context(), std::make_shared<Breaker>());
 
     auto conn = client->get_connection(test_log_context).unwrap();
@@ -85,7 +101,7 @@ TEST(contract_innerspace_tests, SingleRequest) {
 
     Event received_response{};
 
-    conn->async_send(test_log_context, proto_buffer.get_view(),
+    conn->async_send(test_log_context, proto_buffer,
                      [&received_response, &test_log_context](ResultCode<Innerspace::ResponseEnvelope> envelope_r) {
                          //executed after response is received
                          ASSERT_TRUE(envelope_r);
@@ -108,10 +124,18 @@ TEST(contract_innerspace_tests, SingleRequest) {
     client_thread_pool->shutdown();
 }
 
-TEST(contract_innerspace_tests, TenThousandRequests) {
+TEST(contract_innerspace_tests, SingleRequest) {
+    single_request(false);
+}
+
+TEST(contract_innerspace_tests, SingleRequestLocalSocket) {
+    single_request(true);
+}
+
+void ten_thousand_requests(bool local) {
     init_performance_logging_level();
 
-    using Innerspace = Innerspace<DeleteWorkerRequestProto, DeleteWorkerResponseProto>;
+    using Innerspace = DeleteWorkerInnerspace;
 
     const int count = 10000;
     const int connections = 10;
@@ -121,11 +145,7 @@ TEST(contract_innerspace_tests, TenThousandRequests) {
     auto server_thread_pool = std::make_shared<ThreadPool>(server_thread_pool_config);
     server_thread_pool->start();
 
-    Innerspace::Server::Config server_config{
-            make_endpoint("0.0.0.0", 50000),
-            1024,
-            100
-    };
+    Innerspace::Server::Config server_config = make_server_config(local);
 
     std::atomic_int responses_sent{0};
 
@@ -151,7 +171,7 @@ TEST(contract_innerspace_tests, TenThousandRequests) {
                                                                                                                   request->worker_version())));
 
                                                connection->async_send_response(std::move(lc), request_envelope.get_header()->request_id,
-                                                                               response_buffer.get_view(), std::nullopt);
+                                                                               response_buffer, std::nullopt);
                                                responses_sent.fetch_add(1);
                                            });
     server->start();
@@ -161,13 +181,7 @@ TEST(contract_innerspace_tests, TenThousandRequests) {
     auto client_thread_pool = std::make_shared<ThreadPool>(thread_pool_config);
     client_thread_pool->start();
 
-    Innerspace::Client::Config config{
-            "localhost",
-            50000,
-            connections,
-            1024,
-            100
-    };
+    Innerspace::Client::Config config = make_client_config(local, connections);
     auto client = Innerspace::CreateClient(config, buffer_pool, client_thread_pool->get_context(), std::make_shared<Breaker>());
     auto test_log_context = make_test_log_context;
 
@@ -177,7 +191,6 @@ TEST(contract_innerspace_tests, TenThousandRequests) {
     Event received_all{};
     std::atomic_int errors_received{0};
     std::atomic_int responses_received{0};
-    Innerspace::Client::ConnectionS prev_conn{};
     Innerspace::Client::ConnectionS conn{};
 
     Stopwatch sw{test_log_context};
@@ -191,19 +204,11 @@ TEST(contract_innerspace_tests, TenThousandRequests) {
                                                       CreateDeleteWorkerRequestProtoDirect(builder,
                                                                                          log_context_str.c_str(), v, v * 2));
 
-        if (conn) {
-            prev_conn = conn;
-        }
-
         auto conn_r = client->get_connection(test_log_context);
         ASSERT_TRUE(conn_r);
         conn = conn_r.unwrap();
 
-        if (prev_conn) {
-            ASSERT_NE(prev_conn.get(), conn.get());
-        }
-
-        conn->async_send(test_log_context, proto_buffer.get_view(), [&test_log_context, &errors_received, &received_all, &responses_received, v]
+        conn->async_send(test_log_context, proto_buffer, [&test_log_context, &errors_received, &received_all, &responses_received, v]
                 (ResultCode<Innerspace::ResponseEnvelope> envelope_r) {
             if (envelope_r) {
                 auto envelope = envelope_r.unwrap();
@@ -238,3 +243,212 @@ TEST(contract_innerspace_tests, TenThousandRequests) {
 
     init_default_logging_level();
 }
+
+TEST(contract_innerspace_tests, TenThousandRequests) {
+    ten_thousand_requests(false);
+}
+
+TEST(contract_innerspace_tests, TenThousandRequestsLocalSocket) {
+    ten_thousand_requests(true);
+}
+
+TEST(contract_innerspace_tests, RequestDeadline) {
+    using Innerspace = DeleteWorkerInnerspace;
+
+    auto buffer_pool = std::make_shared<BufferPool>(BufferPoolConfig{false});
+
+    ThreadPoolConfig server_thread_pool_config = ThreadPoolConfig::Half();
+    auto server_thread_pool = std::make_shared<ThreadPool>(server_thread_pool_config);
+    server_thread_pool->start();
+
+    //the server never responds, like a stalled worker process
+    std::atomic_int requests_received{0};
+    auto server = Innerspace::CreateServer(make_server_config(false), buffer_pool, server_thread_pool->get_context(),
+                                           [&requests_received](Innerspace::Server::ServerConnectionS connection,
+                                                                Innerspace::RequestEnvelope &&request_envelope) {
+                                               requests_received.fetch_add(1);
+                                           });
+    server->start();
+
+    ThreadPoolConfig thread_pool_config = ThreadPoolConfig::Half();
+    auto client_thread_pool = std::make_shared<ThreadPool>(thread_pool_config);
+    client_thread_pool->start();
+
+    auto client = Innerspace::CreateClient(make_client_config(false, 1), buffer_pool, client_thread_pool->get_context(),
+                                           std::make_shared<Breaker>());
+    auto test_log_context = make_test_log_context;
+
+    auto conn = client->get_connection(test_log_context).unwrap();
+
+    fbs::Builder builder{};
+    auto proto_buffer = finish_and_copy_to_buffer(builder, buffer_pool, CreateDeleteWorkerRequestProtoDirect(builder, "REQ", 1005, 27));
+
+    Event received_response{};
+    std::optional<Code> received_code{};
+
+    conn->async_send(test_log_context, proto_buffer,
+                     [&received_response, &received_code](ResultCode<Innerspace::ResponseEnvelope> envelope_r) {
+                         if (!envelope_r)
+                             received_code = envelope_r.get_error();
+                         received_response.notify_one();
+                     },
+                     std::chrono::steady_clock::now() + std::chrono::milliseconds(100));
+
+    received_response.wait_one();
+
+    ASSERT_TRUE(received_code.has_value());
+    ASSERT_EQ(received_code.value(), Code::Innerspace_RequestTimeout);
+    //only the request timed out, the connection is still usable
+    ASSERT_FALSE(client->is_faulted());
+    ASSERT_EQ(requests_received.load(), 1);
+
+    client->shutdown();
+    server->shutdown();
+
+    server_thread_pool->shutdown();
+    client_thread_pool->shutdown();
+}
+
+TEST(contract_innerspace_tests, LeastOutstandingConnection) {
+    using Innerspace = DeleteWorkerInnerspace;
+
+    auto buffer_pool = std::make_shared<BufferPool>(BufferPoolConfig{false});
+
+    ThreadPoolConfig server_thread_pool_config = ThreadPoolConfig::Half();
+    auto server_thread_pool = std::make_shared<ThreadPool>(server_thread_pool_config);
+    server_thread_pool->start();
+
+    //the server never responds so every request stays outstanding
+    auto server = Innerspace::CreateServer(make_server_config(false), buffer_pool, server_thread_pool->get_context(),
+                                           [](Innerspace::Server::ServerConnectionS connection, Innerspace::RequestEnvelope &&request_envelope) {});
+    server->start();
+
+    ThreadPoolConfig thread_pool_config = ThreadPoolConfig::Half();
+    auto client_thread_pool = std::make_shared<ThreadPool>(thread_pool_config);
+    client_thread_pool->start();
+
+    const int connections = 4;
+    auto client = Innerspace::CreateClient(make_client_config(false, connections), buffer_pool, client_thread_pool->get_context(),
+                                           std::make_shared<Breaker>());
+    auto test_log_context = make_test_log_context;
+
+    fbs::Builder builder{};
+    std::unordered_set<Innerspace::Client::Connection *> used{};
+
+    //each stalled request makes its connection busier than the idle ones, so each request lands on a different connection
+    for (int i = 0; i < connections; ++i) {
+        builder.Clear();
+        auto proto_buffer = finish_and_copy_to_buffer(builder, buffer_pool, CreateDeleteWorkerRequestProtoDirect(builder, "REQ", 1005, 27));
+        auto conn = client->get_connection(test_log_context).unwrap();
+        ASSERT_EQ(conn->get_in_flight_count(), 0);
+        used.insert(conn.get());
+        conn->async_send(test_log_context, proto_buffer, [](ResultCode<Innerspace::ResponseEnvelope> envelope_r) {});
+    }
+
+    ASSERT_EQ(used.size(), connections);
+
+    client->shutdown();
+    server->shutdown();
+
+    server_thread_pool->shutdown();
+    client_thread_pool->shutdown();
+}
+
+TEST(contract_innerspace_tests, OnlyTheProbeClosesTheBreaker) {
+    Breaker breaker{BreakerConfig{std::chrono::milliseconds{10}, std::chrono::milliseconds{100}, 0}};
+    ASSERT_EQ(breaker.try_acquire(), 0);
+
+    ASSERT_TRUE(breaker.fault());
+    ASSERT_FALSE(breaker.try_acquire().has_value());
+
+    breaker.half_open();
+    const auto probe = breaker.try_acquire();
+    ASSERT_TRUE(probe.has_value());
+    ASSERT_NE(probe.value(), 0);
+    ASSERT_FALSE(breaker.try_acquire().has_value());
+
+    //a late response to a request sent before the fault doesn't close it
+    breaker.succeed(0);
+    ASSERT_EQ(breaker.get_state(), BreakerState::HalfOpen);
+
+    breaker.succeed(probe.value());
+    ASSERT_EQ(breaker.get_state(), BreakerState::Closed);
+    ASSERT_EQ(breaker.try_acquire(), 0);
+}
+
+TEST(contract_innerspace_tests, BreakerReconnects) {
+    using Innerspace = DeleteWorkerInnerspace;
+
+    auto buffer_pool = std::make_shared<BufferPool>(BufferPoolConfig{false});
+
+    ThreadPoolConfig server_thread_pool_config = ThreadPoolConfig::Half();
+    auto server_thread_pool = std::make_shared<ThreadPool>(server_thread_pool_config);
+    server_thread_pool->start();
+
+    auto create_server = [&]() {
+        auto server = Innerspace::CreateServer(make_server_config(false), buffer_pool, server_thread_pool->get_context(),
+                                               [buffer_pool](Innerspace::Server::ServerConnectionS connection,
+                                                             Innerspace::RequestEnvelope &&request_envelope) {
+                                                   fbs::Builder builder{};
+                                                   auto response_buffer = finish_and_copy_to_buffer(builder, buffer_pool,
+                                                                                                    CreateDeleteWorkerResponseProto(builder));
+                                                   connection->async_send_response(LogContext{"RESP"}, request_envelope.get_header()->request_id,
+                                                                                   response_buffer, std::nullopt);
+                                               });
+        server->start();
+        return server;
+    };
+
+    ThreadPoolConfig thread_pool_config = ThreadPoolConfig::Half();
+    auto client_thread_pool = std::make_shared<ThreadPool>(thread_pool_config);
+    client_thread_pool->start();
+
+    auto breaker = std::make_shared<Breaker>(BreakerConfig{std::chrono::milliseconds{10}, std::chrono::milliseconds{100}, 0});
+    auto client = Innerspace::CreateClient(make_client_config(false, 1), buffer_pool, client_thread_pool->get_context(), breaker);
+    auto test_log_context = make_test_log_context;
+
+    auto send = [&]() -> std::optional<Code> {
+        auto conn_r = client->get_connection(test_log_context);
+        if (!conn_r)
+            return conn_r.get_error();
+
+        fbs::Builder builder{};
+        auto proto_buffer = finish_and_copy_to_buffer(builder, buffer_pool, CreateDeleteWorkerRequestProtoDirect(builder, "REQ", 1005, 27));
+
+        Event received_response{};
+        std::optional<Code> received_code{};
+        conn_r.unwrap()->async_send(test_log_context, proto_buffer,
+                                    [&received_response, &received_code](ResultCode<Innerspace::ResponseEnvelope> envelope_r) {
+                                        if (!envelope_r)
+                                            received_code = envelope_r.get_error();
+                                        received_response.notify_one();
+                                    });
+        received_response.wait_one();
+        return received_code;
+    };
+
+    auto server = create_server();
+    ASSERT_FALSE(send().has_value());
+
+    //losing the server opens the breaker
+    server->shutdown();
+    while (!breaker->is_faulted()) {
+        send();
+    }
+    ASSERT_EQ(send(), Code::Innerspace_ConnectionFault);
+
+    //the client reconnects on its own once the server is back, then a single probe closes the breaker
+    server = create_server();
+    while (breaker->get_state() != BreakerState::HalfOpen) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_FALSE(send().has_value());
+    ASSERT_EQ(breaker->get_state(), BreakerState::Closed);
+    ASSERT_FALSE(send().has_value());
+
+    client->shutdown();
+    server->shutdown();
+
+    server_thread_pool->shutdown();
+    client_thread_pool->shutdown();
+}
@@ -207,7 +207,7 @@ namespace estate::test {
 
         if (!engine::javascript::is_initialized()) {
             engine::javascript::JavascriptConfig platform_config{
-                    "", ""
+                    "", "", 10485760, false, true, 2000
             };
             engine::javascript::initialize(platform_config);
         }
@@ -229,7 +229,7 @@ namespace estate::test {
 
         if (setup_worker) {
             auto sw = std::make_unique<TestProcessorServices<TestSetupWorkerProcessor, SetupServiceProvider, SetupWorkerResponseProto>>();
-            auto js_runtime = engine::javascript::create_setup_runtime();
+            auto js_runtime = engine::javascript::create_setup_runtime(10485760);
             auto sp = std::make_shared<SetupServiceProvider>(test_services->buffer_pool, test_services->database_manager, js_runtime);
             sw->processor = std::make_unique<TestSetupWorkerProcessor>(SetupWorkerProcessorConfig::Create(worker_id), sp);
             sw->service_provider = sp;
@@ -205,6 +205,7 @@ namespace estate::test {
             UserServiceProvider,
             TestRequestContext<WorkerProcessUserResponseProto>,
             BufferView<UserRequestProto>,
+            CommitRetryMetrics,
             execute>;
     using TestUserProcessorS = std::shared_ptr<TestUserProcessor>;
 
@@ -215,6 +216,7 @@ namespace estate::test {
             DeleteServiceProvider,
             TestRequestContext<DeleteWorkerResponseProto>,
             BufferView<DeleteWorkerRequestProto>,
+            NoExecutorStats,
             execute>;
     using TestDeleteWorkerProcessorS = std::shared_ptr<TestDeleteWorkerProcessor>;
 
@@ -225,6 +227,7 @@ namespace estate::test {
             SetupServiceProvider,
             TestRequestContext<SetupWorkerResponseProto>,
             BufferView<SetupWorkerRequestProto>,
+            NoExecutorStats,
             execute>;
     using TestSetupWorkerProcessorS = std::shared_ptr<TestSetupWorkerProcessor>;
 
@@ -5,6 +5,8 @@
 #include <estate/internal/innerspace/innerspace.h>
 #include <estate/internal/flatbuffers_util.h>
 
+#include <thread>
+
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "cert-err58-cpp"
 
@@ -90,4 +92,108 @@ TEST(unit_buffer_pool_tests, CanUseMessageBuffer) {
     ASSERT_EQ(buffer_pool->buffer_queue_count(), 1);
 }
 
+TEST(unit_buffer_pool_tests, SizeClassesAndRetentionCaps) {
+    BufferPoolConfig buffer_pool_config{
+            true,
+            0, //no thread cache so every release lands in the shared bins
+            2,
+            1024 * 1024,
+            64 * 1024
+    };
+    auto buffer_pool = std::make_shared<BufferPool>(buffer_pool_config);
+
+    {
+        auto big = buffer_pool->get_buffer<u8>(200 * 1024);
+        ASSERT_GE(big.with_internal_buffer<size_t>([](InternalBuffer &b) { return b.capacity(); }), 200 * 1024);
+    }
+    //bigger than max_retained_buffer_size so it was freed
+    ASSERT_EQ(buffer_pool->buffer_queue_count(), 0);
+    ASSERT_EQ(buffer_pool->retained_byte_count(), 0);
+
+    {
+        auto a = buffer_pool->get_buffer<u8>(4096);
+        auto b = buffer_pool->get_buffer<u8>(4096);
+        auto c = buffer_pool->get_buffer<u8>(4096);
+    }
+    //only max_retained_count are kept
+    ASSERT_EQ(buffer_pool->buffer_queue_count(), 2);
+    ASSERT_GE(buffer_pool->retained_byte_count(), 2 * 4096);
+
+    {
+        //far smaller than what's retained so a new buffer is made
+        auto small = buffer_pool->get_buffer<u8>(16);
+        ASSERT_FALSE(small.is_reused());
+        auto same = buffer_pool->get_buffer<u8>(4096);
+        ASSERT_TRUE(same.is_reused());
+        auto larger = buffer_pool->get_buffer<u8>(8192);
+        ASSERT_FALSE(larger.is_reused());
+    }
+    ASSERT_EQ(buffer_pool->outstanding_lease_count(), 0);
+}
+
+TEST(unit_buffer_pool_tests, GetWithoutHintReusesLargerClasses) {
+    BufferPoolConfig buffer_pool_config{
+            true,
+            0 //no thread cache so every release lands in the shared bins
+    };
+    auto buffer_pool = std::make_shared<BufferPool>(buffer_pool_config);
+
+    {
+        auto large = buffer_pool->get_buffer<u8>(1024 * 1024);
+    }
+    ASSERT_EQ(buffer_pool->buffer_queue_count(), 1);
+
+    auto buffer = buffer_pool->get_buffer<u8>();
+    ASSERT_TRUE(buffer.is_reused());
+    ASSERT_EQ(buffer_pool->buffer_queue_count(), 0);
+}
+
+TEST(unit_buffer_pool_tests, ThreadCacheIsPerThread) {
+    auto buffer_pool = std::make_shared<BufferPool>(BufferPoolConfig{true});
+
+    {
+        auto buffer = buffer_pool->get_buffer<u8>(100);
+        ASSERT_FALSE(buffer.is_reused());
+    }
+    ASSERT_EQ(buffer_pool->buffer_queue_count(), 1);
+    ASSERT_EQ(buffer_pool->retained_byte_count(), 0);
+
+    bool other_thread_reused{true};
+    std::thread other([&]() {
+        auto buffer = buffer_pool->get_buffer<u8>(100);
+        other_thread_reused = buffer.is_reused();
+    });
+    other.join();
+    ASSERT_FALSE(other_thread_reused);
+
+    auto buffer = buffer_pool->get_buffer<u8>(100);
+    ASSERT_TRUE(buffer.is_reused());
+}
+
+TEST(unit_buffer_pool_tests, PooledBuilderHandsOverItsBlock) {
+    auto log_context = make_test_log_context;
+    auto buffer_pool = std::make_shared<BufferPool>(BufferPoolConfig{true});
+
+    std::optional<Buffer<DeleteWorkerRequestProto>> first{};
+    {
+        PooledBuilder builder{buffer_pool, 64};
+        first.emplace(finish_to_buffer(builder, CreateDeleteWorkerRequestProtoDirect(builder, log_context.get_context().c_str(), 1, 2)));
+
+        //the builder grabs a fresh block from the pool when reused
+        builder.Reset();
+        auto second = finish_to_buffer(builder, CreateDeleteWorkerRequestProtoDirect(builder, log_context.get_context().c_str(), 3, 4));
+        ASSERT_EQ(second->worker_id(), 3);
+        ASSERT_EQ(second->worker_version(), 4);
+        ASSERT_EQ(buffer_pool->outstanding_lease_count(), 2);
+    }
+    //outlives the builder
+    ASSERT_EQ(buffer_pool->outstanding_lease_count(), 1);
+    auto verifier = flatbuffers::Verifier(first->as_u8(), first->size());
+    ASSERT_TRUE(verifier.VerifyBuffer<DeleteWorkerRequestProto>(nullptr));
+    ASSERT_EQ((*first)->worker_id(), 1);
+    ASSERT_EQ((*first)->worker_version(), 2);
+    first.reset();
+    ASSERT_EQ(buffer_pool->outstanding_lease_count(), 0);
+}
+
 #pragma clang diagnostic pop
@@ -0,0 +1,50 @@
+#include <estate/internal/checksum.h>
+
+#include <string>
+#include <gtest/gtest.h>
+
+using namespace estate;
+
+TEST(unit_checksum_tests, MatchesTheCrc32cCheckValue) {
+    //arrange
+    const std::string input{"123456789"};
+    Crc32c crc{};
+
+    //act
+    crc.process_bytes(input.data(), input.size());
+
+    //assert
+    ASSERT_EQ(0xE3069283, crc.checksum());
+}
+
+TEST(unit_checksum_tests, HardwareAndPortableAgree) {
+    //arrange
+    std::string input{};
+    for (int i = 0; i < 1000; ++i)
+        input.push_back(static_cast<char>(i * 31));
+
+    //act & assert
+    for (size_t size = 0; size < input.size(); size += 37) {
+        Crc32c fast{};
+        Crc32c portable{};
+        fast.process_bytes(input.data(), size);
+        portable.process_bytes_portable(input.data(), size);
+        ASSERT_EQ(portable.checksum(), fast.checksum());
+    }
+}
+
+TEST(unit_checksum_tests, IncrementalEqualsWhole) {
+    //arrange
+    const std::string input{"The quick brown fox jumps over the lazy dog"};
+    Crc32c whole{};
+    Crc32c incremental{};
+
+    //act
+    whole.process_bytes(input.data(), input.size());
+    incremental.process_byte(static_cast<u8>(input[0]));
+    incremental.process_bytes(input.data() + 1, 10);
+    incremental.process_bytes(input.data() + 11, input.size() - 11);
+
+    //assert
+    ASSERT_EQ(whole.checksum(), incremental.checksum());
+}
@@ -0,0 +1,109 @@
+#include <estate/internal/pool.h>
+#include <estate/runtime/code.h>
+
+#include <memory>
+#include <vector>
+#include <thread>
+#include <gtest/gtest.h>
+
+using namespace estate;
+
+using IntPool = Pool<int, Code>;
+
+TEST(unit_pool_tests, AddedResourcesAreLeasedBeforeCreatingNewOnes) {
+    //arrange
+    auto pool = std::make_shared<IntPool>();
+    int created = 0;
+    auto factory = [&created]() {
+        ++created;
+        return ResultCode<std::unique_ptr<int>, Code>::Ok(std::make_unique<int>(0));
+    };
+    auto validate = [](std::unique_ptr<int> &resource) { return *resource == 42; };
+    pool->add_resource(std::make_unique<int>(42));
+
+    //act
+    auto handle_r = pool->get_resource(factory, validate);
+
+    //assert
+    ASSERT_TRUE(handle_r);
+    auto handle = handle_r.unwrap();
+    ASSERT_EQ(*handle.get(), 42);
+    ASSERT_EQ(created, 0);
+    ASSERT_EQ(pool->outstanding_lease_count(), 1);
+}
+
+TEST(unit_pool_tests, PeakOutstandingLeasesIsKept) {
+    //arrange
+    auto pool = std::make_shared<IntPool>();
+    auto factory = []() { return ResultCode<std::unique_ptr<int>, Code>::Ok(std::make_unique<int>(0)); };
+    auto validate = [](std::unique_ptr<int> &) { return true; };
+
+    //act
+    {
+        std::vector<IntPool::Handle> handles{};
+        for (int i = 0; i < 3; ++i)
+            handles.push_back(pool->get_resource(factory, validate).unwrap());
+    }
+    auto handle = pool->get_resource(factory, validate).unwrap();
+
+    //assert
+    ASSERT_EQ(pool->outstanding_lease_count(), 1);
+    ASSERT_EQ(pool->peak_outstanding_lease_count(), 3);
+    ASSERT_EQ(pool->resource_queue_count(), 2);
+}
+
+TEST(unit_pool_tests, WaitsForAFreeResourceAtMaxSize) {
+    //arrange
+    auto pool = std::make_shared<IntPool>(PoolConfig{1, 0, 0});
+    int created = 0;
+    auto factory = [&created]() {
+        ++created;
+        return ResultCode<std::unique_ptr<int>, Code>::Ok(std::make_unique<int>(created));
+    };
+    auto validate = [](std::unique_ptr<int> &) { return true; };
+    auto first = std::make_unique<IntPool::Handle>(pool->get_resource(factory, validate).unwrap());
+    std::atomic_bool leased{false};
+
+    //act
+    std::thread waiter([&]() {
+        auto handle = pool->get_resource(factory, validate).unwrap();
+        leased = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const bool leased_while_full = leased;
+    first.reset();
+    waiter.join();
+
+    //assert
+    ASSERT_FALSE(leased_while_full);
+    ASSERT_TRUE(leased);
+    ASSERT_EQ(created, 1);
+    ASSERT_EQ(pool->resource_count(), 1);
+}
+
+TEST(unit_pool_tests, EvictsIdleResourcesOverBudgetOrTimedOut) {
+    //arrange
+    auto pool = std::make_shared<IntPool>(PoolConfig{0, 20, 100}, [](std::unique_ptr<int> &resource) {
+        return static_cast<size_t>(*resource);
+    });
+    auto validate = [](std::unique_ptr<int> &) { return true; };
+    auto weighted = [](int weight) {
+        return [weight]() { return ResultCode<std::unique_ptr<int>, Code>::Ok(std::make_unique<int>(weight)); };
+    };
+
+    //act
+    {
+        auto a = pool->get_resource(weighted(60), validate).unwrap();
+        auto b = pool->get_resource(weighted(60), validate).unwrap();
+    }
+    const auto count_after_release = pool->resource_count();
+    const auto weight_after_release = pool->total_weight();
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    pool->evict_idle();
+
+    //assert
+    ASSERT_EQ(count_after_release, 1);
+    ASSERT_EQ(weight_after_release, 60);
+    ASSERT_EQ(pool->resource_count(), 0);
+    ASSERT_EQ(pool->evicted_count(), 2);
+}
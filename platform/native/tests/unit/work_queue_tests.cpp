@@ -0,0 +1,241 @@
+#include <estate/internal/processor/work_queue.h>
+
+#include <memory>
+#include <gtest/gtest.h>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+using namespace estate;
+
+TEST(unit_work_queue_tests, PostDoesNotWaitForWork) {
+    //arrange
+    WorkQueue work_queue{WorkQueueConfig{2, 16, 1000}};
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool release = false;
+    std::atomic_int finished{0};
+
+    //act
+    const auto posted_on = std::this_thread::get_id();
+    std::atomic_bool ran_on_posting_thread{false};
+    for (int i = 0; i < 4; ++i) {
+        work_queue.post([&]() {
+            if (std::this_thread::get_id() == posted_on)
+                ran_on_posting_thread = true;
+            std::unique_lock<std::mutex> lck(mutex);
+            cv.wait(lck, [&]() { return release; });
+            ++finished;
+        });
+    }
+
+    //assert
+    ASSERT_EQ(finished, 0); //still blocked, but the posts returned
+    //both threads may have picked up work before the later posts, but the last two always wait behind them
+    ASSERT_GE(work_queue.get_stats().max_depth_seen, 2);
+    {
+        std::unique_lock<std::mutex> lck(mutex);
+        release = true;
+    }
+    cv.notify_all();
+    while (finished < 4)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ASSERT_FALSE(ran_on_posting_thread);
+    work_queue.shutdown();
+    const auto stats = work_queue.get_stats();
+    ASSERT_EQ(stats.executed, 4);
+    ASSERT_EQ(stats.ran_inline, 0);
+    ASSERT_EQ(stats.depth, 0);
+}
+
+TEST(unit_work_queue_tests, FullQueueRunsInline) {
+    //arrange
+    WorkQueue work_queue{WorkQueueConfig{1, 1, 1000}};
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool release = false;
+    std::atomic_bool first_done{false};
+
+    //act
+    work_queue.post([&]() {
+        std::unique_lock<std::mutex> lck(mutex);
+        cv.wait(lck, [&]() { return release; });
+        first_done = true;
+    });
+    //wait until the first item is running so the second one fills the queue
+    while (work_queue.get_stats().depth != 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    work_queue.post([]() {});
+    std::thread::id inline_thread{};
+    work_queue.post([&]() { inline_thread = std::this_thread::get_id(); });
+
+    //assert
+    ASSERT_EQ(inline_thread, std::this_thread::get_id());
+    ASSERT_EQ(work_queue.get_stats().ran_inline, 1);
+    {
+        std::unique_lock<std::mutex> lck(mutex);
+        release = true;
+    }
+    cv.notify_all();
+    work_queue.shutdown();
+    ASSERT_TRUE(first_done);
+}
+
+TEST(unit_work_queue_tests, NoThreadsRunsInline) {
+    WorkQueue work_queue{WorkQueueConfig{}};
+    ASSERT_TRUE(work_queue.is_inline());
+    std::thread::id ran_on{};
+    work_queue.post([&]() { ran_on = std::this_thread::get_id(); });
+    ASSERT_EQ(ran_on, std::this_thread::get_id());
+}
+
+TEST(unit_work_queue_tests, OrderedWorkWithTheSameKeyRunsOneAtATimeInOrder) {
+    //arrange
+    WorkQueue work_queue{WorkQueueConfig{4, 64, 1000}};
+    std::mutex mutex;
+    std::vector<int> order{};
+    std::atomic_int running{0};
+    std::atomic_bool overlapped{false};
+    std::atomic_int finished{0};
+
+    //act
+    for (int i = 0; i < 32; ++i) {
+        work_queue.post_ordered("counter", [&, i]() {
+            if (running.fetch_add(1) != 0)
+                overlapped = true;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            {
+                std::unique_lock<std::mutex> lck(mutex);
+                order.push_back(i);
+            }
+            running.fetch_sub(1);
+            ++finished;
+        });
+    }
+    while (finished < 32)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    //assert
+    ASSERT_FALSE(overlapped);
+    for (int i = 0; i < 32; ++i)
+        ASSERT_EQ(order[i], i);
+    ASSERT_GT(work_queue.get_stats().ordered_waits, 0);
+    work_queue.shutdown();
+}
+
+TEST(unit_work_queue_tests, OrderedWorkWithDifferentKeysRunsInParallel) {
+    //arrange
+    WorkQueue work_queue{WorkQueueConfig{2, 16, 1000}};
+    std::mutex mutex;
+    std::condition_variable cv;
+    int started{0};
+    std::atomic_int finished{0};
+
+    //act, each waits until both have started so this only finishes if they run at the same time
+    for (const auto key: {"a", "b"}) {
+        work_queue.post_ordered(key, [&]() {
+            std::unique_lock<std::mutex> lck(mutex);
+            ++started;
+            cv.notify_all();
+            cv.wait(lck, [&]() { return started == 2; });
+            ++finished;
+        });
+    }
+    while (finished < 2)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    //assert
+    ASSERT_EQ(work_queue.get_stats().ordered_waits, 0);
+    work_queue.shutdown();
+}
+
+TEST(unit_work_queue_tests, OrderedWorkRunsInlineWithoutThreads) {
+    WorkQueue work_queue{WorkQueueConfig{}};
+    std::vector<int> order{};
+    work_queue.post_ordered("key", [&]() { order.push_back(1); });
+    work_queue.post_ordered("key", [&]() { order.push_back(2); });
+    ASSERT_EQ(order, (std::vector<int>{1, 2}));
+}
+
+TEST(unit_work_queue_tests, OrderedWorkWaitingForItsKeyCountsTowardMaxDepth) {
+    //arrange
+    WorkQueue work_queue{WorkQueueConfig{1, 2, 1000}};
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool release = false;
+    std::atomic_int finished{0};
+
+    //act
+    work_queue.post_ordered("key", [&]() {
+        std::unique_lock<std::mutex> lck(mutex);
+        cv.wait(lck, [&]() { return release; });
+        ++finished;
+    });
+    //wait until the first item is running so the next ones wait for the key
+    while (work_queue.get_stats().depth != 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    for (int i = 0; i < 2; ++i)
+        work_queue.post_ordered("key", [&]() { ++finished; });
+    std::thread::id inline_thread{};
+    work_queue.post_ordered("key", [&]() {
+        inline_thread = std::this_thread::get_id();
+        ++finished;
+    });
+
+    //assert
+    ASSERT_EQ(inline_thread, std::this_thread::get_id());
+    auto stats = work_queue.get_stats();
+    ASSERT_EQ(stats.depth, 2);
+    ASSERT_EQ(stats.ordered_waits, 2);
+    ASSERT_EQ(stats.ran_inline, 1);
+    {
+        std::unique_lock<std::mutex> lck(mutex);
+        release = true;
+    }
+    cv.notify_all();
+    while (finished < 4)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    work_queue.shutdown();
+    stats = work_queue.get_stats();
+    ASSERT_EQ(stats.depth, 0);
+    ASSERT_EQ(stats.executed, 3);
+}
+
+TEST(unit_work_queue_tests, PostAfterDoesNotHoldAThreadOrTheKey) {
+    //arrange
+    WorkQueue work_queue{WorkQueueConfig{1, 16, 1000}};
+    std::mutex mutex;
+    std::vector<int> order{};
+    std::atomic_int finished{0};
+    const auto posted = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration delayed_after{};
+
+    //act, the only thread and the key stay free while the delayed work waits
+    work_queue.post_after("key", std::chrono::milliseconds(50), [&]() {
+        delayed_after = std::chrono::steady_clock::now() - posted;
+        std::unique_lock<std::mutex> lck(mutex);
+        order.push_back(1);
+        ++finished;
+    });
+    work_queue.post_ordered("key", [&]() {
+        std::unique_lock<std::mutex> lck(mutex);
+        order.push_back(2);
+        ++finished;
+    });
+    while (finished < 2)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    //assert
+    ASSERT_EQ(order, (std::vector<int>{2, 1}));
+    ASSERT_GE(delayed_after, std::chrono::milliseconds(50));
+    work_queue.shutdown();
+}
+
+TEST(unit_work_queue_tests, PostAfterWaitsOnThePostingThreadWithoutThreads) {
+    WorkQueue work_queue{WorkQueueConfig{}};
+    bool ran{false};
+    const auto posted = std::chrono::steady_clock::now();
+    work_queue.post_after(std::nullopt, std::chrono::milliseconds(50), [&]() { ran = true; });
+    ASSERT_TRUE(ran);
+    ASSERT_GE(std::chrono::steady_clock::now() - posted, std::chrono::milliseconds(50));
+}
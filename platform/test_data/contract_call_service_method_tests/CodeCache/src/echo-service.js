@@ -0,0 +1,10 @@
+import {Service} from "worker-runtime";
+
+class EchoService extends Service {
+    constructor(primaryKey) {
+        super(primaryKey);
+    }
+    echo(value) {
+        return value;
+    }
+}
@@ -0,0 +1,14 @@
+import {Service} from "worker-runtime";
+
+class LoopService extends Service {
+    constructor(primaryKey) {
+        super(primaryKey);
+    }
+    loopForever() {
+        while (true) {
+        }
+    }
+    ping() {
+        return "pong";
+    }
+}